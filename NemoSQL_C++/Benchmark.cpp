@@ -0,0 +1,392 @@
+//------------------------------------------------------------------------------
+//  Benchmark.cpp
+//------------------------------------------------------------------------------
+// Benchmark times every enumeration engine of the tree on a set of input
+// graphs for a range of subgraph sizes, and writes the results as JSON.
+//
+// Peak memory is the kernel's resident high-water mark (VmHWM). Before every
+// case it is reset through /proc/self/clear_refs so each result shows the peak
+// of that case alone; where that is not possible the process-wide peak from
+// getrusage is reported instead, which only ever grows.
+//
+// Hardware counters, when asked for, are read around each run of a case and
+// kept for the fastest run. Counters the system refuses (as it usually does
+// inside containers) are left out of the output rather than failing the run.
+//
+// ASSUMPTIONS:
+//   -- input files are formatted as described in Graph.h
+//   -- 2 <= minK <= maxK <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <set>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Census.h"
+
+//----------------------------------- escape -----------------------------------
+// JSON string literal of text
+// Preconditions: None
+// Postconditions: Returns text quoted, with quotes, backslashes and control
+//                 characters escaped
+static string escape(const string &text)
+{
+    string quoted = "\"";
+
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += string("\\") + c;
+        else if ((unsigned char)c < 0x20)
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            quoted += code;
+        }
+        else
+            quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+//------------------------------ resetPeakMemory -------------------------------
+// Starts a new resident memory high-water mark
+// Preconditions: None
+// Postconditions: Returns true if the kernel reset VmHWM
+static bool resetPeakMemory()
+{
+    ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+    clear.close();
+    return !clear.fail();
+}
+
+//--------------------------------- peakMemory ---------------------------------
+// Resident memory high-water mark in kilobytes
+// Preconditions: None
+// Postconditions: Returns VmHWM if the kernel reports it, and the peak of the
+//                 whole process from getrusage otherwise
+static long long peakMemory()
+{
+    ifstream status("/proc/self/status");
+    string line;
+
+    while (getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return atoll(line.c_str() + 6);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+//-------------------------------- threadCounts --------------------------------
+// Thread counts to scale over
+// Preconditions: most >= 1
+// Postconditions: Returns 1, 2, 4, ... below most, followed by most
+static vector<int> threadCounts(const int &most)
+{
+    vector<int> counts;
+
+    for (int t = 1; t < most; t *= 2)
+        counts.push_back(t);
+    counts.push_back(most);
+
+    return counts;
+}
+
+//--------------------------------- edgeCount ----------------------------------
+// Number of edges of graph
+// Preconditions: None
+// Postconditions: Returns half the sum of the degrees
+static long long edgeCount(const Graph &graph)
+{
+    long long degrees = 0;
+
+    for (int v = 0; v < graph.size(); v++)
+        degrees += graph.neighbors(v).size();
+
+    return degrees / 2;
+}
+
+//--------------------------------- Constructor --------------------------------
+// Creates a benchmark over the given options
+// Preconditions: options.threads >= 1, options.repetitions >= 1
+// Postconditions: Nothing is run yet
+Benchmark::Benchmark(const BenchmarkOptions &options) : options(options)
+{
+    if (options.counters)
+        perf.reset(new PerfCounters());
+}
+
+//------------------------------ PRIVATE: measure ------------------------------
+// Times one case
+// Preconditions: body returns the number of subgraphs it found
+// Postconditions: The best of options.repetitions runs of body is added to
+//                 results, filled in from prototype, and written to log
+template <class Body>
+const BenchmarkResult &Benchmark::measure(const BenchmarkResult &prototype,
+                                          ostream &log, Body body)
+{
+    BenchmarkResult result = prototype;
+    bool resettable = resetPeakMemory();
+
+    for (int r = 0; r < options.repetitions; r++)
+    {
+        if (perf)
+            perf->start();
+        auto start = chrono::steady_clock::now();
+        result.subgraphs = body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() -
+                                                  start).count();
+        if (perf)
+            perf->stop();
+
+        if (r == 0 || seconds < result.seconds)
+        {
+            result.seconds = seconds;
+            for (int c = 0; c < PerfCounters::COUNTERS; c++)
+                result.counts[c] = perf ? perf->get((PerfCounters::Counter)c)
+                                        : -1;
+        }
+    }
+
+    result.peakKilobytes = peakMemory();
+
+    log << result.input << " k=" << result.k << " " << result.variant
+        << " threads=" << result.threads << ": " << result.subgraphs
+        << " subgraphs in " << result.seconds << " s, "
+        << result.peakKilobytes << " kB peak"
+        << (resettable ? "" : " (process)");
+
+    const long long cycles = result.counts[PerfCounters::CYCLES];
+    const long long instructions = result.counts[PerfCounters::INSTRUCTIONS];
+    if (cycles > 0 && result.subgraphs > 0)
+        log << ", " << (double)cycles / result.subgraphs << " cycles/subgraph";
+    if (cycles > 0 && instructions >= 0)
+        log << ", IPC " << (double)instructions / cycles;
+    log << endl;
+
+    results.push_back(result);
+    return results.back();
+}
+
+//------------------------------------- run ------------------------------------
+// Runs every variant on every input for every k
+// Preconditions: None
+// Postconditions: getResults() holds one result per case run; one line
+//                 per case is written to log. Inputs that cannot be opened
+//                 are reported to log and skipped
+void Benchmark::run(ostream &log)
+{
+    results.clear();
+    if (perf && !perf->available())
+        log << "Hardware counters are not available, running without them"
+            << endl;
+
+    vector<int> scaling = threadCounts(options.threads);
+
+    for (const string &input : options.inputs)
+    {
+        ifstream infile(input);
+        if (!infile)
+        {
+            log << input << " could not be opened, skipped" << endl;
+            continue;
+        }
+
+        Graph graph;
+        graph.buildGraph(infile);
+
+        // Variants (with their thread count) that took longer than
+        // options.slowSeconds; they only get slower as k grows
+        set<pair<string, int>> slow;
+
+        for (int k = options.minK; k <= options.maxK; k++)
+        {
+            BenchmarkResult prototype;
+            prototype.input = input;
+            prototype.vertices = graph.size();
+            prototype.edges = edgeCount(graph);
+            prototype.k = k;
+
+            // Every variant must find as many subgraphs as the first one run
+            long long expected = -1;
+            auto timed = [&](const string &variant, const int &threads,
+                             const function<long long()> &body)
+            {
+                if (slow.count(make_pair(variant, threads)))
+                    return;
+
+                prototype.variant = variant;
+                prototype.threads = threads;
+                const BenchmarkResult &result = measure(prototype, log, body);
+                if (result.seconds > options.slowSeconds)
+                    slow.insert(make_pair(variant, threads));
+
+                if (expected < 0)
+                    expected = result.subgraphs;
+                else if (result.subgraphs != expected)
+                    log << "  " << variant << " found " << result.subgraphs
+                        << " subgraphs, expected " << expected << endl;
+            };
+
+            timed("visitor", 1, [&]()
+            {
+                CountVisitor counter;
+                graph.enumerateSubgraph(k, counter);
+                return counter.count;
+            });
+
+            timed("baseline", 1, [&]()
+            {
+                return graph.countSubgraphs(k);
+            });
+
+            for (int threads : scaling)
+                timed("parallel", threads, [&]()
+                {
+                    vector<CountVisitor> counters(threads);
+                    vector<EnumerationState> states(threads);
+                    for (EnumerationState &state : states)
+                        state.reset(k, graph.size());
+
+                    parallelFor(0, graph.size(), threads, ROOT_CHUNK,
+                                [&](int thread, int begin, int end)
+                    {
+                        for (int root = begin; root < end; root++)
+                            graph.enumerateRoot(root, k, counters[thread],
+                                                states[thread]);
+                    });
+
+                    long long total = 0;
+                    for (const CountVisitor &counter : counters)
+                        total += counter.count;
+                    return total;
+                });
+
+            for (int threads : scaling)
+                timed("census", threads, [&]()
+                {
+                    CensusOptions census;
+                    census.threads = threads;
+
+                    Census counts(graph, k);
+                    counts.run(census);
+                    return counts.getTotal();
+                });
+        }
+    }
+}
+
+//--------------------------------- getResults ---------------------------------
+// Results of the last run
+// Preconditions: None
+// Postconditions: Returns the results in the order they were run
+const vector<BenchmarkResult> &Benchmark::getResults() const
+{
+    return results;
+}
+
+//--------------------------------- writeJson ----------------------------------
+// Writes the results as one JSON document
+// Preconditions: None
+// Postconditions: A "context" object describing the machine and build and a
+//                 "benchmarks" array with one object per result are written
+//                 to out
+void Benchmark::writeJson(ostream &out) const
+{
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+#ifdef NEMO_STATS
+    const bool stats = true;
+#else
+    const bool stats = false;
+#endif
+
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": " << escape(date) << ",\n"
+        << "    \"host\": " << escape(host) << ",\n"
+        << "    \"hardware_threads\": " << defaultThreads() << ",\n"
+        << "    \"repetitions\": " << options.repetitions << ",\n"
+        << "    \"nemo_stats\": " << (stats ? "true" : "false") << ",\n"
+        << "    \"perf_counters\": " << (perf && perf->available() ? "true"
+                                                                 : "false")
+        << "\n  },\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &r = results[i];
+        double rate = r.seconds > 0 ? r.subgraphs / r.seconds : 0;
+
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"input\": " << escape(r.input)
+            << ", \"vertices\": " << r.vertices
+            << ", \"edges\": " << r.edges
+            << ", \"variant\": " << escape(r.variant)
+            << ", \"k\": " << r.k
+            << ", \"threads\": " << r.threads
+            << ", \"subgraphs\": " << r.subgraphs
+            << ", \"seconds\": " << r.seconds
+            << ", \"subgraphs_per_second\": " << rate
+            << ", \"peak_rss_kb\": " << r.peakKilobytes;
+
+        // Counters that could not be read are left out
+        for (int c = 0; c < PerfCounters::COUNTERS; c++)
+        {
+            if (r.counts[c] < 0)
+                continue;
+
+            string name = PerfCounters::name((PerfCounters::Counter)c);
+            out << ", \"" << name << "\": " << r.counts[c];
+            if (r.subgraphs > 0)
+                out << ", \"" << name << "_per_subgraph\": "
+                    << (double)r.counts[c] / r.subgraphs;
+        }
+
+        out << "}";
+    }
+
+    out << "\n  ]\n}" << endl;
+}
+
+//--------------------------------- listInputs ---------------------------------
+// Files of a directory, for running on every bundled input
+// Preconditions: None
+// Postconditions: Returns the paths of the regular files in directory in
+//                 sorted order, or nothing if it cannot be read
+vector<string> Benchmark::listInputs(const string &directory)
+{
+    vector<string> paths;
+
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        return paths;
+
+    while (struct dirent *entry = readdir(dir))
+    {
+        string path = directory + "/" + entry->d_name;
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+            paths.push_back(path);
+    }
+    closedir(dir);
+
+    sort(paths.begin(), paths.end());
+    return paths;
+}
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+//  Benchmark.h
+//------------------------------------------------------------------------------
+// Benchmark times every enumeration engine of the tree on a set of input
+// graphs for a range of subgraph sizes, and writes the results as JSON so that
+// runs of two commits can be diffed. The engine variants are:
+//   -- baseline   the original Graph::enumerateSubgraph(k), one thread
+//   -- visitor    the ESU engine with a CountVisitor, one thread
+//   -- parallel   the ESU engine with a CountVisitor per thread
+//   -- census     Census, i.e. enumeration plus cached classification
+// The threaded variants are run for 1, 2, 4, ... threads up to the maximum, so
+// the results show the scaling. Every result holds the subgraphs found, the
+// best wall time over the repetitions, the throughput and the peak resident
+// memory of the run. With options.counters the hardware counters of the run
+// (see PerfCounters.h) are recorded too, and reported per subgraph found.
+//
+// ASSUMPTIONS:
+//   -- input files are formatted as described in Graph.h
+//   -- 2 <= minK <= maxK <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Benchmark__
+#define __NemoSQL__Benchmark__
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "Parallel.h"
+#include "PerfCounters.h"
+
+using namespace std;
+
+struct BenchmarkOptions
+{
+    vector<string> inputs;                  // edge-list files to run on
+    int minK = 3;                           // smallest subgraph size
+    int maxK = 6;                           // largest subgraph size
+    int threads = defaultThreads();         // most threads to scale to
+    int repetitions = 1;                    // runs per case, best one kept
+    double slowSeconds = 60;                // a variant slower than this is
+                                            // not run for larger k
+    bool counters = false;                  // read hardware counters
+};
+
+struct BenchmarkResult
+{
+    string input;                           // input file
+    int vertices = 0;                       // vertex slots of the graph
+    long long edges = 0;                    // edges of the graph
+    string variant;                         // engine variant
+    int k = 0;                              // subgraph size
+    int threads = 1;                        // worker threads
+    long long subgraphs = 0;                // size-k subgraphs found
+    double seconds = 0;                     // best wall time
+    long long peakKilobytes = 0;            // peak resident memory
+    long long counts[PerfCounters::COUNTERS] = {-1, -1, -1, -1, -1};
+                                            // hardware counts of the best
+                                            // run, -1 if not read
+};
+
+class Benchmark
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a benchmark over the given options
+    // Preconditions: options.threads >= 1, options.repetitions >= 1
+    // Postconditions: Nothing is run yet
+    Benchmark(const BenchmarkOptions &options);
+
+
+    //----------------------------------- run ----------------------------------
+    // Runs every variant on every input for every k
+    // Preconditions: None
+    // Postconditions: getResults() holds one result per case run; one line
+    //                 per case is written to log. Inputs that cannot be opened
+    //                 are reported to log and skipped
+    void run(ostream &log);
+
+
+    //-------------------------------- getResults ------------------------------
+    // Results of the last run
+    // Preconditions: None
+    // Postconditions: Returns the results in the order they were run
+    const vector<BenchmarkResult> &getResults() const;
+
+
+    //-------------------------------- writeJson -------------------------------
+    // Writes the results as one JSON document
+    // Preconditions: None
+    // Postconditions: A "context" object describing the machine and build and a
+    //                 "benchmarks" array with one object per result are written
+    //                 to out
+    void writeJson(ostream &out) const;
+
+
+    //-------------------------------- listInputs ------------------------------
+    // Files of a directory, for running on every bundled input
+    // Preconditions: None
+    // Postconditions: Returns the paths of the regular files in directory in
+    //                 sorted order, or nothing if it cannot be read
+    static vector<string> listInputs(const string &directory);
+
+
+private:
+    BenchmarkOptions options;               // what to run
+    vector<BenchmarkResult> results;        // what was run
+    unique_ptr<PerfCounters> perf;          // null unless options.counters
+
+
+    //---------------------------- PRIVATE: measure ----------------------------
+    // Times one case
+    // Preconditions: body returns the number of subgraphs it found
+    // Postconditions: The best of options.repetitions runs of body is added to
+    //                 results, filled in from prototype, and written to log
+    template <class Body>
+    const BenchmarkResult &measure(const BenchmarkResult &prototype,
+                                   ostream &log, Body body);
+
+};
+
+#endif /* defined(__NemoSQL__Benchmark__) */
@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------
+//  Census.cpp
+//------------------------------------------------------------------------------
+// Census counts the connected size-k subgraphs of a Graph per isomorphism
+// class. Roots are enumerated in parallel; every worker thread owns its
+// enumeration buffers, Classifier cache and class counts, and folds them into
+// the shared result once per chunk of roots.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a Census refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "Census.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include "Progress.h"
+
+const int CLASSIFY_SAMPLE = 64;             // classifications per timed one
+
+#ifdef NEMO_STATS
+//-------------------------------- clockOverhead -------------------------------
+// Seconds one pair of steady_clock reads adds to what it measures
+// Preconditions: None
+// Postconditions: Returns the average over a thousand back-to-back pairs
+static double clockOverhead()
+{
+    const int pairs = 1000;
+    double total = 0;
+
+    for (int i = 0; i < pairs; i++)
+    {
+        auto started = chrono::steady_clock::now();
+        total += chrono::duration<double>(chrono::steady_clock::now() -
+                                          started).count();
+    }
+
+    return total / pairs;
+}
+#endif
+
+//--------------------------------- Constructor --------------------------------
+// Creates a census of the size-k subgraphs of graph
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: No subgraph is counted yet
+Census::Census(const Graph &graph, const int &k) : graph(graph), k(k) {}
+
+//----------------------------- Worker Constructor -----------------------------
+// Per-thread visitor for size-k subgraphs of an n-vertex graph
+// Preconditions: None
+// Postconditions: Nothing is counted yet
+Census::Worker::Worker(const int &k, const int &n) : classifier(k)
+{
+    state.reset(k, n);
+    STATS(overhead = clockOverhead());
+}
+
+//------------------------------------- run ------------------------------------
+// Counts every connected size-k subgraph by class
+// Preconditions: options.threads >= 1
+// Postconditions: getCounts() holds the census. With options.resume the
+//                 roots and counts of a matching checkpoint are taken as is;
+//                 with options.checkpoint the progress is saved every
+//                 options.checkpointSeconds and once more at the end;
+//                 with options.progressSeconds > 0 progress is reported as
+//                 described in Progress.h (otherwise no reporter thread runs
+//                 and SIGUSR1 is left alone)
+void Census::run(const CensusOptions &options)
+{
+    Checkpoint saved;
+    saved.k = k;
+    saved.vertices = graph.size();
+
+    const bool checkpointing = !options.checkpoint.empty();
+    if (checkpointing)
+        saved.fingerprint = Checkpoint::fingerprintOf(graph);
+
+    if (options.resume && checkpointing &&
+        !saved.load(options.checkpoint, graph, k))
+        cerr << "No usable checkpoint in " << options.checkpoint
+             << ", starting over" << endl;
+
+    vector<char> skip(graph.size(), 0);
+    for (const pair<int, int> &range : saved.done)
+        for (int root = range.first; root < range.second; root++)
+            skip[root] = 1;
+
+    typedef chrono::steady_clock Clock;
+    const auto interval = chrono::seconds(options.checkpointSeconds);
+    auto lastSave = Clock::now();
+
+    vector<Worker *> workers(options.threads, nullptr);
+    mutex merge;
+    stats = EngineStats();
+
+    long long resumed = 0;
+    for (const auto &entry : saved.counts)
+        resumed += entry.second;
+
+    auto snapshot = [&](ostream &out)
+    {
+        lock_guard<mutex> lock(merge);
+        for (const auto &entry : saved.counts)
+            out << Classifier::toGraph6(entry.first, k) << "\t"
+                << entry.second << "\n";
+        STATS(stats.write(out, k));
+        out << flush;
+    };
+
+    // Only a reporting census starts the reporter thread and takes SIGUSR1,
+    // so library callers (Ensemble, the SQLite extension) leave both alone
+    unique_ptr<Progress> progress;
+    if (options.progressSeconds > 0)
+        progress.reset(new Progress(graph.size(),
+                                    max(0.0, options.expectedLeaves - resumed),
+                                    options.progressSeconds, snapshot));
+
+    parallelFor(0, graph.size(), options.threads, ROOT_CHUNK,
+                [&](int thread, int begin, int end)
+    {
+        if (workers[thread] == nullptr)
+            workers[thread] = new Worker(k, graph.size());
+        Worker &worker = *workers[thread];
+
+        STATS(auto started = Clock::now());
+
+        for (int root = begin; root < end; root++)
+            if (!skip[root])
+                graph.enumerateRoot(root, k, worker, worker.state);
+
+        STATS(worker.state.stats.enumerateSeconds +=
+              chrono::duration<double>(Clock::now() - started).count());
+
+        // Counts and finished roots move to the checkpoint together, so a
+        // saved checkpoint never holds the counts of a half-done root
+        lock_guard<mutex> lock(merge);
+        long long leaves = 0;
+        for (const auto &entry : worker.counts)
+        {
+            saved.counts[entry.first] += entry.second;
+            leaves += entry.second;
+        }
+        worker.counts.clear();
+        saved.markDone(begin, end);
+        if (progress)
+            progress->add(end - begin, leaves);
+
+        STATS(worker.classifier.moveCounters(worker.state.stats));
+        STATS(stats.add(worker.state.stats));
+        STATS(worker.state.stats = EngineStats());
+
+        if (checkpointing && Clock::now() - lastSave >= interval)
+        {
+            if (!saved.save(options.checkpoint))
+                cerr << "Could not write " << options.checkpoint << endl;
+            lastSave = Clock::now();
+        }
+    });
+
+    for (Worker *worker : workers)
+        delete worker;
+
+    if (checkpointing && !saved.save(options.checkpoint))
+        cerr << "Could not write " << options.checkpoint << endl;
+
+    // The SIGUSR1 snapshot may still be reading saved.counts
+    lock_guard<mutex> lock(merge);
+    counts.swap(saved.counts);
+}
+
+//---------------------------------- getCounts ---------------------------------
+// Count of every class found by the last run
+// Preconditions: None
+// Postconditions: Returns canonical mask -> number of instances
+const ClassCounts &Census::getCounts() const
+{
+    return counts;
+}
+
+//---------------------------------- getStats ----------------------------------
+// Engine statistics of the last run
+// Preconditions: None
+// Postconditions: Returns the counters summed over all threads; they are
+//                 all zero unless compiled with -DNEMO_STATS
+const EngineStats &Census::getStats() const
+{
+    return stats;
+}
+
+//---------------------------------- getTotal ----------------------------------
+// Number of subgraphs found by the last run
+// Preconditions: None
+// Postconditions: Returns the sum of getCounts()
+long long Census::getTotal() const
+{
+    long long total = 0;
+    for (const auto &entry : counts)
+        total += entry.second;
+
+    return total;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes one "graph6 count" line per class
+// Preconditions: None
+// Postconditions: The census is written to out
+void Census::write(ostream &out) const
+{
+    for (const auto &entry : counts)
+        out << Classifier::toGraph6(entry.first, k) << "\t" << entry.second
+            << "\n";
+}
+
+//-------------------------------- Worker: visit -------------------------------
+// Counts one instance under its class
+// Preconditions: mask is the packed adjacency of subgraph
+// Postconditions: The count of the class of mask is one more
+void Census::Worker::visit(const int *, const int &, const uint64_t &mask)
+{
+    // Reading the clock costs as much as a cached lookup, so only every
+    // CLASSIFY_SAMPLE-th call is timed and counted for all of them
+    STATS(const bool timed = sampled++ % CLASSIFY_SAMPLE == 0);
+    STATS(auto started = timed ? chrono::steady_clock::now()
+                               : chrono::steady_clock::time_point());
+
+    uint64_t type = classifier.classify(mask);
+
+    STATS(if (timed) state.stats.classifySeconds += CLASSIFY_SAMPLE *
+              max(0.0, chrono::duration<double>(chrono::steady_clock::now() -
+                                                started).count() - overhead));
+
+    counts[type]++;
+}
+
+//------------------------------ Worker: visitRows -----------------------------
+// Counts the leaves under a prefix under their classes
+// Preconditions: mask is the packed adjacency of the k-1 vertices of prefix;
+//                counts[i] leaves add row rows[i] to it
+// Postconditions: The count of the class of every row is counts[i] more
+void Census::Worker::visitRows(const int *, const int &k, const uint64_t &mask,
+                               const uint32_t *rows, const int *counts,
+                               const int &distinct)
+{
+    const int offset = (k - 1) * (k - 2) / 2;
+
+    STATS(const bool timed = sampled++ % CLASSIFY_SAMPLE == 0);
+    STATS(auto started = timed ? chrono::steady_clock::now()
+                               : chrono::steady_clock::time_point());
+
+    for (int i = 0; i < distinct; i++)
+        this->counts[classifier.classify(mask | (uint64_t)rows[i] << offset)]
+            += counts[i];
+
+    STATS(if (timed) state.stats.classifySeconds += CLASSIFY_SAMPLE *
+              max(0.0, chrono::duration<double>(chrono::steady_clock::now() -
+                                                started).count() - overhead));
+}
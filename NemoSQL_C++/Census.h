@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//  Census.h
+//------------------------------------------------------------------------------
+// Census counts the connected size-k subgraphs of a Graph per isomorphism
+// class. Roots are enumerated in parallel; every worker thread owns its
+// enumeration buffers, Classifier cache and class counts, and folds them into
+// the shared result once per chunk of roots.
+// features are included:
+//   -- per-class counts keyed by canonical mask, printed as graph6
+//   -- periodic checkpoints of the finished roots and their counts, and
+//      resuming from such a checkpoint
+//   -- live progress lines, and the partial census on SIGUSR1 (see Progress)
+//   -- engine statistics in builds compiled with -DNEMO_STATS (see Stats.h)
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a Census refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Census__
+#define __NemoSQL__Census__
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include "Checkpoint.h"
+#include "Classifier.h"
+#include "Enumeration.h"
+#include "Graph.h"
+#include "Parallel.h"
+#include "Stats.h"
+
+using namespace std;
+
+struct CensusOptions
+{
+    int threads = defaultThreads();         // worker threads
+    string checkpoint;                      // checkpoint file, empty for none
+    int checkpointSeconds = 60;             // seconds between checkpoints
+    bool resume = false;                    // skip roots in the checkpoint
+    int progressSeconds = 0;                // seconds between progress lines
+    double expectedLeaves = 0;              // predicted subgraphs, for the ETA
+};
+
+class Census
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a census of the size-k subgraphs of graph
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: No subgraph is counted yet
+    Census(const Graph &graph, const int &k);
+
+
+    //----------------------------------- run ----------------------------------
+    // Counts every connected size-k subgraph by class
+    // Preconditions: options.threads >= 1
+    // Postconditions: getCounts() holds the census. With options.resume the
+    //                 roots and counts of a matching checkpoint are taken as is;
+    //                 with options.checkpoint the progress is saved every
+    //                 options.checkpointSeconds and once more at the end;
+    //                 with options.progressSeconds > 0 progress is reported
+    //                 as described in Progress.h (otherwise no reporter
+    //                 thread runs and SIGUSR1 is left alone)
+    void run(const CensusOptions &options = CensusOptions());
+
+
+    //-------------------------------- getCounts -------------------------------
+    // Count of every class found by the last run
+    // Preconditions: None
+    // Postconditions: Returns canonical mask -> number of instances
+    const ClassCounts &getCounts() const;
+
+
+    //-------------------------------- getTotal --------------------------------
+    // Number of subgraphs found by the last run
+    // Preconditions: None
+    // Postconditions: Returns the sum of getCounts()
+    long long getTotal() const;
+
+
+    //-------------------------------- getStats --------------------------------
+    // Engine statistics of the last run
+    // Preconditions: None
+    // Postconditions: Returns the counters summed over all threads; they are
+    //                 all zero unless compiled with -DNEMO_STATS
+    const EngineStats &getStats() const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes one "graph6 count" line per class
+    // Preconditions: None
+    // Postconditions: The census is written to out
+    void write(ostream &out) const;
+
+
+    // Per-thread visitor of the enumeration. A Worker only depends on k and
+    // the number of vertex slots, so it (and its class cache) can be reused
+    // for any graph of the same size (see Ensemble)
+    struct Worker
+    {
+        Worker(const int &k, const int &n);
+
+        //--------------------------------- visit ------------------------------
+        // Counts one instance under its class
+        // Preconditions: mask is the packed adjacency of subgraph
+        // Postconditions: The count of the class of mask is one more
+        void visit(const int *subgraph, const int &k, const uint64_t &mask);
+
+        //------------------------------- visitRows ----------------------------
+        // Counts the leaves under a prefix under their classes
+        // Preconditions: mask is the packed adjacency of the k-1 vertices of
+        //                prefix; counts[i] leaves add row rows[i] to it
+        // Postconditions: The count of the class of every row is counts[i]
+        //                 more
+        void visitRows(const int *prefix, const int &k, const uint64_t &mask,
+                       const uint32_t *rows, const int *counts,
+                       const int &distinct);
+
+        Classifier classifier;              // per-thread class cache
+        unordered_map<uint64_t, long long> counts;  // counts of this chunk
+        EnumerationState state;             // enumeration buffers
+        unsigned sampled = 0;               // classifications, for timing
+        double overhead = 0;                // cost of reading the clock
+    };
+
+
+private:
+    const Graph &graph;                     // graph being counted
+    int k;                                  // subgraph size
+    ClassCounts counts;                     // result of run
+    EngineStats stats;                      // statistics of run
+
+};
+
+#endif /* defined(__NemoSQL__Census__) */
@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+//  Checkpoint.cpp
+//------------------------------------------------------------------------------
+// Checkpoint is the saved progress of a Census: which roots have been fully
+// enumerated and the per-class counts of exactly those roots. It is stored as
+// a small binary file that is replaced atomically.
+//
+// ASSUMPTIONS:
+//   -- a checkpoint is only resumed against the graph and k it was made for;
+//      load() rejects files whose k or fingerprint do not match
+//
+//------------------------------------------------------------------------------
+
+#include "Checkpoint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'N', 'E', 'M', 'O', 'C', 'K', 'P', 'T'};
+static const uint32_t VERSION = 1;
+
+//----------------------------------- fnv1a ------------------------------------
+// 64-bit FNV-1a hash of size bytes
+// Preconditions: None
+// Postconditions: Returns the hash of data
+static uint64_t fnv1a(const char *data, const size_t &size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+    return hash;
+}
+
+//------------------------------------- put ------------------------------------
+// Appends the bytes of value to out
+// Preconditions: None
+// Postconditions: sizeof(value) bytes are appended
+template <class T>
+static void put(string &out, const T &value)
+{
+    out.append((const char *)&value, sizeof(value));
+}
+
+//------------------------------------- get ------------------------------------
+// Reads a value at position pos of in
+// Preconditions: None
+// Postconditions: Returns false if in is too short; otherwise value is read
+//                 and pos moves past it
+template <class T>
+static bool get(const string &in, size_t &pos, T &value)
+{
+    if (pos + sizeof(value) > in.size())
+        return false;
+
+    memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+//-------------------------------- fingerprintOf -------------------------------
+// Order-independent hash of the edges of graph
+// Preconditions: None
+// Postconditions: Returns the same value for graphs with the same edges
+uint64_t Checkpoint::fingerprintOf(const Graph &graph)
+{
+    uint64_t sum = 0, mix = 0;
+
+    for (int u = 0; u < graph.size(); u++)
+        for (int v : graph.neighbors(u))
+            if (u < v)
+            {
+                uint64_t edge = (uint64_t)u << 32 | (uint32_t)v;
+                uint64_t hash = fnv1a((const char *)&edge, sizeof(edge));
+                sum += hash;
+                mix ^= hash * 0x9E3779B97F4A7C15ULL;
+            }
+
+    return sum ^ (mix << 1 | mix >> 63);
+}
+
+//----------------------------------- markDone ---------------------------------
+// Records that every root in [begin, end) has been enumerated
+// Preconditions: begin <= end
+// Postconditions: The range is merged into done
+void Checkpoint::markDone(const int &begin, const int &end)
+{
+    auto at = lower_bound(done.begin(), done.end(), make_pair(begin, end));
+    at = done.insert(at, make_pair(begin, end));
+
+    // Coalesce with the neighbors that touch or overlap the new range
+    size_t i = at - done.begin();
+    if (i > 0 && done[i - 1].second >= done[i].first)
+    {
+        done[i - 1].second = max(done[i - 1].second, done[i].second);
+        done.erase(done.begin() + i);
+        i--;
+    }
+    while (i + 1 < done.size() && done[i].second >= done[i + 1].first)
+    {
+        done[i].second = max(done[i].second, done[i + 1].second);
+        done.erase(done.begin() + i + 1);
+    }
+}
+
+//------------------------------------- save -----------------------------------
+// Atomically replaces the file at path with this checkpoint
+// Preconditions: None
+// Postconditions: Returns true if the new file is in place
+bool Checkpoint::save(const string &path) const
+{
+    string out(MAGIC, sizeof(MAGIC));
+    put(out, VERSION);
+    put(out, (int32_t)k);
+    put(out, (int32_t)vertices);
+    put(out, fingerprint);
+
+    put(out, (uint64_t)done.size());
+    for (const pair<int, int> &range : done)
+    {
+        put(out, (int32_t)range.first);
+        put(out, (int32_t)range.second);
+    }
+
+    put(out, (uint64_t)counts.size());
+    for (const auto &entry : counts)
+    {
+        put(out, entry.first);
+        put(out, (int64_t)entry.second);
+    }
+
+    put(out, fnv1a(out.data(), out.size()));
+
+    string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    bool written = fwrite(out.data(), 1, out.size(), file) == out.size() &&
+                   fflush(file) == 0 && fsync(fileno(file)) == 0;
+    written = fclose(file) == 0 && written;
+
+    if (!written || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------- load -----------------------------------
+// Reads a checkpoint saved for size-k subgraphs of graph
+// Preconditions: None
+// Postconditions: Returns true and replaces this checkpoint if path holds a
+//                 valid checkpoint for graph and k; otherwise returns false
+//                 and leaves this checkpoint unchanged
+bool Checkpoint::load(const string &path, const Graph &graph, const int &k)
+{
+    ifstream infile(path, ios::binary);
+    if (!infile)
+        return false;
+
+    stringstream buffer;
+    buffer << infile.rdbuf();
+    const string in = buffer.str();
+
+    if (in.size() < sizeof(MAGIC) + sizeof(uint64_t) ||
+        memcmp(in.data(), MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+
+    size_t body = in.size() - sizeof(uint64_t);
+    size_t pos = body;
+    uint64_t checksum;
+    if (!get(in, pos, checksum) || checksum != fnv1a(in.data(), body))
+        return false;
+
+    Checkpoint loaded;
+    pos = sizeof(MAGIC);
+    uint32_t version;
+    int32_t size, count;
+    uint64_t ranges, classes;
+
+    if (!get(in, pos, version) || version != VERSION ||
+        !get(in, pos, size) || !get(in, pos, count) ||
+        !get(in, pos, loaded.fingerprint) || !get(in, pos, ranges))
+        return false;
+
+    loaded.k = size;
+    loaded.vertices = count;
+    if (loaded.k != k || loaded.vertices != graph.size() ||
+        loaded.fingerprint != fingerprintOf(graph))
+        return false;
+
+    for (uint64_t i = 0; i < ranges; i++)
+    {
+        int32_t begin, end;
+        if (!get(in, pos, begin) || !get(in, pos, end) || pos > body)
+            return false;
+        loaded.done.push_back(make_pair(begin, end));
+    }
+
+    if (!get(in, pos, classes))
+        return false;
+
+    for (uint64_t i = 0; i < classes; i++)
+    {
+        uint64_t mask;
+        int64_t total;
+        if (!get(in, pos, mask) || !get(in, pos, total) || pos > body)
+            return false;
+        loaded.counts[mask] = total;
+    }
+
+    if (pos != body)
+        return false;
+
+    *this = loaded;
+    return true;
+}
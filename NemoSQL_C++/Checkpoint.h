@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+//  Checkpoint.h
+//------------------------------------------------------------------------------
+// Checkpoint is the saved progress of a Census: which roots have been fully
+// enumerated and the per-class counts of exactly those roots. It is stored as
+// a small binary file that is replaced atomically (written next to the target
+// and renamed over it), so a crash while saving leaves the previous checkpoint
+// intact.
+//
+// File layout (little endian, as written by the host):
+//   char[8]   "NEMOCKPT"
+//   uint32    version
+//   int32     k
+//   int32     number of vertex slots of the graph
+//   uint64    graph fingerprint
+//   uint64    number of root ranges, then that many int32 [begin, end) pairs
+//   uint64    number of classes, then that many (uint64 mask, int64 count)
+//   uint64    checksum of everything above
+//
+// ASSUMPTIONS:
+//   -- a checkpoint is only resumed against the graph and k it was made for;
+//      load() rejects files whose k or fingerprint do not match
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Checkpoint__
+#define __NemoSQL__Checkpoint__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+typedef map<uint64_t, long long> ClassCounts;   // canonical mask -> count
+
+class Checkpoint
+{
+public:
+    int k = 0;                              // subgraph size
+    int vertices = 0;                       // vertex slots of the graph
+    uint64_t fingerprint = 0;               // identifies the graph
+    vector<pair<int, int>> done;            // finished [begin, end) roots
+    ClassCounts counts;                     // counts of the finished roots
+
+
+    //------------------------------- fingerprintOf ----------------------------
+    // Order-independent hash of the edges of graph
+    // Preconditions: None
+    // Postconditions: Returns the same value for graphs with the same edges
+    static uint64_t fingerprintOf(const Graph &graph);
+
+
+    //---------------------------------- markDone ------------------------------
+    // Records that every root in [begin, end) has been enumerated
+    // Preconditions: begin <= end
+    // Postconditions: The range is merged into done
+    void markDone(const int &begin, const int &end);
+
+
+    //---------------------------------- save ----------------------------------
+    // Atomically replaces the file at path with this checkpoint
+    // Preconditions: None
+    // Postconditions: Returns true if the new file is in place
+    bool save(const string &path) const;
+
+
+    //---------------------------------- load ----------------------------------
+    // Reads a checkpoint saved for size-k subgraphs of graph
+    // Preconditions: None
+    // Postconditions: Returns true and replaces this checkpoint if path holds a
+    //                 valid checkpoint for graph and k; otherwise returns false
+    //                 and leaves this checkpoint unchanged
+    bool load(const string &path, const Graph &graph, const int &k);
+
+};
+
+#endif /* defined(__NemoSQL__Checkpoint__) */
@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+//  Classifier.cpp
+//------------------------------------------------------------------------------
+// Classifier maps a size-k subgraph to its isomorphism class. A subgraph is
+// given as a packed adjacency mask over its k vertices: the pair (i, j) with
+// i < j is stored at bit j*(j-1)/2 + i, which is the same upper-triangle,
+// column-by-column order graph6 uses.
+//
+// ASSUMPTIONS:
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE, so that a mask fits in 64 bits
+//   -- a Classifier is used by one thread at a time
+//
+//------------------------------------------------------------------------------
+
+#include "Classifier.h"
+
+#include <algorithm>
+#include <vector>
+#include "Stats.h"
+
+//--------------------------------- Constructor --------------------------------
+// Creates a classifier for size-k subgraphs
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: The cache is empty
+Classifier::Classifier(const int &k) : k(k) {}
+
+//---------------------------------- classify ----------------------------------
+// Class of a size-k subgraph
+// Preconditions: mask only uses the low k*(k-1)/2 bits
+// Postconditions: Returns the canonical mask of the subgraph; the result is
+//                 remembered so the next lookup of mask is a hash probe
+uint64_t Classifier::classify(const uint64_t &mask)
+{
+    auto found = cache.find(mask);
+    if (found != cache.end())
+    {
+        STATS(hits++);
+        return found->second;
+    }
+
+    STATS(misses++);
+    uint64_t result = canonical(mask, k);
+    cache.emplace(mask, result);
+
+    return result;
+}
+
+//----------------------------------- getSize ----------------------------------
+// Size of the subgraphs this classifier handles
+// Preconditions: None
+// Postconditions: Returns k
+int Classifier::getSize() const
+{
+    return k;
+}
+
+//-------------------------------- moveCounters --------------------------------
+// Hands the cache hits and misses counted so far to stats (counted only
+// with NEMO_STATS)
+// Preconditions: None
+// Postconditions: The counters are added to stats and reset to zero
+void Classifier::moveCounters(EngineStats &stats)
+{
+    stats.cacheHits += hits;
+    stats.cacheMisses += misses;
+    hits = misses = 0;
+}
+
+//---------------------------------- canonical ---------------------------------
+// Canonical mask of a size-k subgraph without touching any cache
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Returns the smallest mask over all relabelings that are
+//                 consistent with the refined vertex coloring
+uint64_t Classifier::canonical(const uint64_t &mask, const int &k)
+{
+    int adj[MAX_SUBGRAPH_SIZE] = {0};
+
+    for (int j = 1; j < k; j++)
+        for (int i = 0; i < j; i++)
+            if (mask >> pairBit(i, j) & 1)
+            {
+                adj[i] |= 1 << j;
+                adj[j] |= 1 << i;
+            }
+
+    // Color refinement: start from degrees and split colors by the multiset of
+    // neighbor colors until nothing changes. Colors are ranks of label-free
+    // signatures, so the resulting ordered partition is isomorphism invariant.
+    vector<long> color(k);
+    for (int i = 0; i < k; i++)
+        color[i] = __builtin_popcount(adj[i]);
+
+    int classes = 0;
+    for (;;)
+    {
+        vector<vector<long>> signature(k);
+        for (int i = 0; i < k; i++)
+        {
+            signature[i].push_back(color[i]);
+            vector<long> around;
+            for (int j = 0; j < k; j++)
+                if (adj[i] >> j & 1)
+                    around.push_back(color[j]);
+            sort(around.begin(), around.end());
+            signature[i].insert(signature[i].end(), around.begin(), around.end());
+        }
+
+        vector<vector<long>> sorted(signature);
+        sort(sorted.begin(), sorted.end());
+        sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+
+        for (int i = 0; i < k; i++)
+            color[i] = lower_bound(sorted.begin(), sorted.end(), signature[i])
+                       - sorted.begin();
+
+        if ((int)sorted.size() == classes)
+            break;
+        classes = (int)sorted.size();
+    }
+
+    // Order vertices by color, then try every ordering inside each color cell
+    int order[MAX_SUBGRAPH_SIZE];
+    for (int i = 0; i < k; i++)
+        order[i] = i;
+    sortSmall(order, k, [&](int a, int b)
+    {
+        return color[a] != color[b] ? color[a] < color[b] : a < b;
+    });
+
+    vector<int> cellStart;
+    for (int i = 0; i < k; i++)
+        if (i == 0 || color[order[i]] != color[order[i - 1]])
+            cellStart.push_back(i);
+    cellStart.push_back(k);
+
+    uint64_t best = UINT64_MAX;
+    for (;;)
+    {
+        uint64_t candidate = 0;
+        for (int j = 1; j < k; j++)
+            for (int i = 0; i < j; i++)
+                if (adj[order[i]] >> order[j] & 1)
+                    candidate |= (uint64_t)1 << pairBit(i, j);
+        best = min(best, candidate);
+
+        // Odometer over the cells: advance the last cell that still has a next
+        // permutation, resetting every cell after it
+        int cell = (int)cellStart.size() - 2;
+        for (; cell >= 0; cell--)
+        {
+            if (next_permutation(order + cellStart[cell],
+                                 order + cellStart[cell + 1]))
+                break;
+        }
+
+        if (cell < 0)
+            break;
+    }
+
+    return best;
+}
+
+//---------------------------------- toGraph6 ----------------------------------
+// graph6 string of a size-k subgraph
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Returns the graph6 encoding of mask
+string Classifier::toGraph6(const uint64_t &mask, const int &k)
+{
+    int bits = k * (k - 1) / 2;
+    string g6(1, (char)(k + 63));
+
+    for (int start = 0; start < bits; start += 6)
+    {
+        int group = 0;
+        for (int b = start; b < start + 6; b++)
+            group = group << 1 | (b < bits ? (int)(mask >> b & 1) : 0);
+        g6 += (char)(group + 63);
+    }
+
+    return g6;
+}
+
+//--------------------------------- fromGraph6 ---------------------------------
+// Parse a graph6 string into a packed mask
+// Preconditions: None
+// Postconditions: Returns true and sets mask and k if g6 is a valid graph6
+//                 string of at most MAX_SUBGRAPH_SIZE vertices
+bool Classifier::fromGraph6(const string &g6, uint64_t &mask, int &k)
+{
+    if (g6.empty())
+        return false;
+
+    int n = g6[0] - 63;
+    int bits = n * (n - 1) / 2;
+    if (n < 2 || n > MAX_SUBGRAPH_SIZE || (int)g6.size() != 1 + (bits + 5) / 6)
+        return false;
+
+    mask = 0;
+    for (int b = 0; b < bits; b++)
+    {
+        int group = g6[1 + b / 6] - 63;
+        if (group < 0 || group > 63)
+            return false;
+        if (group >> (5 - b % 6) & 1)
+            mask |= (uint64_t)1 << b;
+    }
+
+    k = n;
+    return true;
+}
+
+//--------------------------------- parseMotif ---------------------------------
+// Parse a motif given on the command line
+// Preconditions: None
+// Postconditions: Accepts "triangle", "clique4" or a graph6 string; returns
+//                 true and sets the canonical mask and k on success
+bool Classifier::parseMotif(const string &name, uint64_t &mask, int &k)
+{
+    if (name == "triangle")
+    {
+        k = 3;
+        mask = (1 << 3) - 1;
+    }
+    else if (name == "clique4")
+    {
+        k = 4;
+        mask = (1 << 6) - 1;
+    }
+    else if (!fromGraph6(name, mask, k))
+        return false;
+
+    mask = canonical(mask, k);
+    return true;
+}
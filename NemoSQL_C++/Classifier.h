@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//  Classifier.h
+//------------------------------------------------------------------------------
+// Classifier maps a size-k subgraph to its isomorphism class. A subgraph is
+// given as a packed adjacency mask over its k vertices: the pair (i, j) with
+// i < j is stored at bit j*(j-1)/2 + i, which is the same upper-triangle,
+// column-by-column order graph6 uses. The class of a subgraph is the smallest
+// mask among all relabelings that respect a color refinement of its vertices,
+// so two subgraphs are isomorphic exactly when their classes are equal.
+// features are included:
+//   -- canonical class of a packed mask, cached per Classifier
+//   -- conversion between packed masks and graph6 strings
+//
+// ASSUMPTIONS:
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE, so that a mask fits in 64 bits
+//   -- a Classifier is used by one thread at a time
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Classifier__
+#define __NemoSQL__Classifier__
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+const int MAX_SUBGRAPH_SIZE = 11;           // k*(k-1)/2 must fit in 64 bits
+
+struct EngineStats;
+
+//----------------------------------- pairBit ----------------------------------
+// Bit of the pair (i, j) in a packed adjacency mask
+// Preconditions: 0 <= i < j < MAX_SUBGRAPH_SIZE
+// Postconditions: Returns j*(j-1)/2 + i
+inline int pairBit(const int &i, const int &j)
+{
+    return j * (j - 1) / 2 + i;
+}
+
+//--------------------------------- sortSmall ----------------------------------
+// Insertion sort for the at most MAX_SUBGRAPH_SIZE vertices of a subgraph,
+// which beats std::sort at that size and gives GCC no out-of-range paths to
+// warn about on fixed-size arrays
+// Preconditions: less is a strict weak ordering
+// Postconditions: values[0..count) is in ascending order by less
+template <typename Less>
+inline void sortSmall(int *values, const int &count, Less less)
+{
+    for (int i = 1; i < count; i++)
+    {
+        int value = values[i], j = i;
+        for (; j > 0 && less(value, values[j - 1]); j--)
+            values[j] = values[j - 1];
+        values[j] = value;
+    }
+}
+
+//--------------------------------- sortSmall ----------------------------------
+// Sorts the at most MAX_SUBGRAPH_SIZE vertices of a subgraph ascending
+// Preconditions: None
+// Postconditions: values[0..count) is in ascending order
+inline void sortSmall(int *values, const int &count)
+{
+    sortSmall(values, count, [](int a, int b) { return a < b; });
+}
+
+class Classifier
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a classifier for size-k subgraphs
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: The cache is empty
+    Classifier(const int &k);
+
+
+    //-------------------------------- classify --------------------------------
+    // Class of a size-k subgraph
+    // Preconditions: mask only uses the low k*(k-1)/2 bits
+    // Postconditions: Returns the canonical mask of the subgraph; the result is
+    //                 remembered so the next lookup of mask is a hash probe
+    uint64_t classify(const uint64_t &mask);
+
+
+    //--------------------------------- getSize --------------------------------
+    // Size of the subgraphs this classifier handles
+    // Preconditions: None
+    // Postconditions: Returns k
+    int getSize() const;
+
+
+    //------------------------------- moveCounters -----------------------------
+    // Hands the cache hits and misses counted so far to stats (counted only
+    // with NEMO_STATS)
+    // Preconditions: None
+    // Postconditions: The counters are added to stats and reset to zero
+    void moveCounters(EngineStats &stats);
+
+
+    //------------------------------- canonical --------------------------------
+    // Canonical mask of a size-k subgraph without touching any cache
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Returns the smallest mask over all relabelings that are
+    //                 consistent with the refined vertex coloring
+    static uint64_t canonical(const uint64_t &mask, const int &k);
+
+
+    //-------------------------------- toGraph6 --------------------------------
+    // graph6 string of a size-k subgraph
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Returns the graph6 encoding of mask
+    static string toGraph6(const uint64_t &mask, const int &k);
+
+
+    //------------------------------- fromGraph6 -------------------------------
+    // Parse a graph6 string into a packed mask
+    // Preconditions: None
+    // Postconditions: Returns true and sets mask and k if g6 is a valid graph6
+    //                 string of at most MAX_SUBGRAPH_SIZE vertices
+    static bool fromGraph6(const string &g6, uint64_t &mask, int &k);
+
+
+    //------------------------------- parseMotif -------------------------------
+    // Parse a motif given on the command line
+    // Preconditions: None
+    // Postconditions: Accepts "triangle", "clique4" or a graph6 string; returns
+    //                 true and sets the canonical mask and k on success
+    static bool parseMotif(const string &name, uint64_t &mask, int &k);
+
+
+private:
+    int k;                                      // subgraph size
+    unordered_map<uint64_t, uint64_t> cache;    // mask -> canonical mask
+    long long hits = 0;                         // lookups found in cache
+    long long misses = 0;                       // lookups computed
+
+};
+
+#endif /* defined(__NemoSQL__Classifier__) */
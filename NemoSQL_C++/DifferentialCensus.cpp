@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//  DifferentialCensus.cpp
+//------------------------------------------------------------------------------
+// DifferentialCensus compares the size-k census of two versions of a network
+// by counting the first and updating it with the edges that differ.
+//
+// ASSUMPTIONS:
+//   -- neither Graph is modified while a DifferentialCensus refers to them
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "DifferentialCensus.h"
+
+#include <algorithm>
+#include <iterator>
+#include "Classifier.h"
+#include "EdgeSet.h"
+#include "IncrementalCensus.h"
+
+//--------------------------------- Constructor --------------------------------
+// Creates a comparison of the size-k censuses of before and after
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Nothing is counted yet
+DifferentialCensus::DifferentialCensus(const Graph &before, const Graph &after,
+                                       const int &k)
+    : before(before), after(after), k(k) {}
+
+//------------------------------------- run ------------------------------------
+// Counts before in full and derives the census of after from it
+// Preconditions: threads >= 1
+// Postconditions: getBefore() and getAfter() hold both censuses; if instances
+//                 is given, one "- vertices graph6" line per disappeared and
+//                 one "+ vertices graph6" line per appeared instance is
+//                 written to it, vertices ascending
+void DifferentialCensus::run(const int &threads, ostream *instances)
+{
+    vector<uint64_t> old = edges(before), updated = edges(after);
+    removed.clear();
+    added.clear();
+    set_difference(old.begin(), old.end(), updated.begin(), updated.end(),
+                   back_inserter(removed));
+    set_difference(updated.begin(), updated.end(), old.begin(), old.end(),
+                   back_inserter(added));
+
+    Graph current(before);
+    IncrementalCensus census(current, k);
+    census.run(threads);
+    beforeCounts = census.getCounts();
+
+    appeared = disappeared = 0;
+    census.setListener([&](const int *subgraph, const int &k,
+                           const uint64_t &from, const uint64_t &to)
+    {
+        disappeared += from != 0;
+        appeared += to != 0;
+        if (instances == nullptr)
+            return;
+
+        int sorted[MAX_SUBGRAPH_SIZE];
+        copy(subgraph, subgraph + k, sorted);
+        sortSmall(sorted, k);
+
+        for (int side = 0; side < 2; side++)
+        {
+            uint64_t type = side == 0 ? from : to;
+            if (type == 0)
+                continue;
+
+            *instances << (side == 0 ? "-" : "+");
+            for (int i = 0; i < k; i++)
+                *instances << "\t" << sorted[i];
+            *instances << "\t" << Classifier::toGraph6(type, k) << "\n";
+        }
+    });
+
+    census.apply(removed, added);
+    afterCounts = census.getCounts();
+}
+
+//---------------------------------- getBefore ---------------------------------
+// Census of the first version
+// Preconditions: None
+// Postconditions: Returns canonical mask -> number of instances
+const ClassCounts &DifferentialCensus::getBefore() const
+{
+    return beforeCounts;
+}
+
+//---------------------------------- getAfter ----------------------------------
+// Census of the second version
+// Preconditions: None
+// Postconditions: Returns canonical mask -> number of instances
+const ClassCounts &DifferentialCensus::getAfter() const
+{
+    return afterCounts;
+}
+
+//--------------------------------- getRemoved ---------------------------------
+// Edges of the first version missing from the second
+// Preconditions: None
+// Postconditions: Returns the packed edges (see EdgeSet.h), ascending
+const vector<uint64_t> &DifferentialCensus::getRemoved() const
+{
+    return removed;
+}
+
+//---------------------------------- getAdded ----------------------------------
+// Edges of the second version missing from the first
+// Preconditions: None
+// Postconditions: Returns the packed edges (see EdgeSet.h), ascending
+const vector<uint64_t> &DifferentialCensus::getAdded() const
+{
+    return added;
+}
+
+//--------------------------------- getAppeared --------------------------------
+// Number of instances that appeared
+// Preconditions: None
+// Postconditions: Returns the k-sets that are connected after the change and
+//                 were disconnected or of another class before
+long long DifferentialCensus::getAppeared() const
+{
+    return appeared;
+}
+
+//------------------------------- getDisappeared -------------------------------
+// Number of instances that disappeared
+// Preconditions: None
+// Postconditions: Returns the k-sets that were connected before the change
+//                 and are disconnected or of another class after
+long long DifferentialCensus::getDisappeared() const
+{
+    return disappeared;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes one "graph6 before after" line per class found in either version
+// Preconditions: None
+// Postconditions: Both censuses are written to out side by side
+void DifferentialCensus::write(ostream &out) const
+{
+    ClassCounts classes(beforeCounts);
+    classes.insert(afterCounts.begin(), afterCounts.end());
+
+    for (const auto &entry : classes)
+    {
+        auto old = beforeCounts.find(entry.first);
+        auto updated = afterCounts.find(entry.first);
+        out << Classifier::toGraph6(entry.first, k) << "\t"
+            << (old == beforeCounts.end() ? 0 : old->second) << "\t"
+            << (updated == afterCounts.end() ? 0 : updated->second) << "\n";
+    }
+}
+
+//------------------------------- PRIVATE: edges -------------------------------
+// Edge list of graph
+// Preconditions: None
+// Postconditions: Returns the packed edges of graph, ascending
+vector<uint64_t> DifferentialCensus::edges(const Graph &graph)
+{
+    vector<uint64_t> list;
+    for (int u = 0; u < graph.size(); u++)
+        for (int v : graph.neighbors(u))
+            if (u < v)
+                list.push_back(edgeKey(u, v));
+
+    sort(list.begin(), list.end());
+    return list;
+}
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+//  DifferentialCensus.h
+//------------------------------------------------------------------------------
+// DifferentialCensus compares the size-k census of two versions of a network,
+// such as successive releases of an interactome, without counting the second
+// version from scratch.
+//
+// The first version is counted in full. The edge lists of the two versions
+// are then diffed, and the removed and added edges are applied as one batch
+// to an IncrementalCensus of the first version, which only enumerates the
+// k-sets that contain a changed vertex pair. Every such k-set whose class
+// changes is an instance that disappeared from its old class, appeared in its
+// new one, or both; these can be written out as they are found.
+//
+// Vertex IDs are taken to name the same vertex in both versions.
+//
+// ASSUMPTIONS:
+//   -- neither Graph is modified while a DifferentialCensus refers to them
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__DifferentialCensus__
+#define __NemoSQL__DifferentialCensus__
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Checkpoint.h"
+#include "Graph.h"
+#include "Parallel.h"
+
+using namespace std;
+
+class DifferentialCensus
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a comparison of the size-k censuses of before and after
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Nothing is counted yet
+    DifferentialCensus(const Graph &before, const Graph &after, const int &k);
+
+
+    //----------------------------------- run ----------------------------------
+    // Counts before in full and derives the census of after from it
+    // Preconditions: threads >= 1
+    // Postconditions: getBefore() and getAfter() hold both censuses; if
+    //                 instances is given, one "- vertices graph6" line per
+    //                 disappeared and one "+ vertices graph6" line per
+    //                 appeared instance is written to it, vertices ascending
+    void run(const int &threads = defaultThreads(),
+             ostream *instances = nullptr);
+
+
+    //-------------------------------- getBefore -------------------------------
+    // Census of the first version
+    // Preconditions: None
+    // Postconditions: Returns canonical mask -> number of instances
+    const ClassCounts &getBefore() const;
+
+
+    //-------------------------------- getAfter --------------------------------
+    // Census of the second version
+    // Preconditions: None
+    // Postconditions: Returns canonical mask -> number of instances
+    const ClassCounts &getAfter() const;
+
+
+    //------------------------------- getRemoved -------------------------------
+    // Edges of the first version missing from the second
+    // Preconditions: None
+    // Postconditions: Returns the packed edges (see EdgeSet.h), ascending
+    const vector<uint64_t> &getRemoved() const;
+
+
+    //-------------------------------- getAdded --------------------------------
+    // Edges of the second version missing from the first
+    // Preconditions: None
+    // Postconditions: Returns the packed edges (see EdgeSet.h), ascending
+    const vector<uint64_t> &getAdded() const;
+
+
+    //------------------------------- getAppeared ------------------------------
+    // Number of instances that appeared
+    // Preconditions: None
+    // Postconditions: Returns the k-sets that are connected after the change
+    //                 and were disconnected or of another class before
+    long long getAppeared() const;
+
+
+    //----------------------------- getDisappeared -----------------------------
+    // Number of instances that disappeared
+    // Preconditions: None
+    // Postconditions: Returns the k-sets that were connected before the
+    //                 change and are disconnected or of another class after
+    long long getDisappeared() const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes one "graph6 before after" line per class found in either version
+    // Preconditions: None
+    // Postconditions: Both censuses are written to out side by side
+    void write(ostream &out) const;
+
+
+private:
+    const Graph &before;                    // first version
+    const Graph &after;                     // second version
+    int k;                                  // subgraph size
+    ClassCounts beforeCounts;               // census of before
+    ClassCounts afterCounts;                // census of after
+    vector<uint64_t> removed;               // edges only in before
+    vector<uint64_t> added;                 // edges only in after
+    long long appeared = 0;                 // instances new to their class
+    long long disappeared = 0;              // instances gone from their class
+
+
+    //----------------------------- PRIVATE: edges -----------------------------
+    // Edge list of graph
+    // Preconditions: None
+    // Postconditions: Returns the packed edges of graph, ascending
+    static vector<uint64_t> edges(const Graph &graph);
+
+};
+
+#endif /* defined(__NemoSQL__DifferentialCensus__) */
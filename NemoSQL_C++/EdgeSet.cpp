@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+//  EdgeSet.cpp
+//------------------------------------------------------------------------------
+// EdgeSet is a flat open-addressing hash set of undirected edges, probed
+// linearly and kept at most half full.
+//
+// ASSUMPTIONS:
+//   -- vertex IDs are below 2^32 - 1
+//
+//------------------------------------------------------------------------------
+
+#include "EdgeSet.h"
+
+const uint64_t EdgeSet::EMPTY;
+
+//--------------------------------- Constructor --------------------------------
+// Creates an empty set with room for capacity edges
+// Preconditions: None
+// Postconditions: size() == 0
+EdgeSet::EdgeSet(const size_t &capacity)
+{
+    size_t size = 16;
+    while (size < 2 * capacity)
+        size *= 2;
+
+    resize(size);
+}
+
+//---------------------------------- contains ----------------------------------
+// Whether the set holds an edge
+// Preconditions: key is an edgeKey
+// Postconditions: Returns true if key is in the set
+bool EdgeSet::contains(const uint64_t &key) const
+{
+    for (size_t i = home(key); ; i = (i + 1) & mask)
+    {
+        if (slots[i] == key)
+            return true;
+        if (slots[i] == EMPTY)
+            return false;
+    }
+}
+
+//----------------------------------- insert -----------------------------------
+// Adds an edge
+// Preconditions: key is an edgeKey
+// Postconditions: Returns false if key was already in the set
+bool EdgeSet::insert(const uint64_t &key)
+{
+    if (2 * (count + 1) > slots.size())
+        resize(2 * slots.size());
+
+    size_t i = home(key);
+    for (; slots[i] != EMPTY; i = (i + 1) & mask)
+        if (slots[i] == key)
+            return false;
+
+    slots[i] = key;
+    count++;
+    return true;
+}
+
+//------------------------------------ erase -----------------------------------
+// Removes an edge
+// Preconditions: key is an edgeKey
+// Postconditions: Returns false if key was not in the set
+bool EdgeSet::erase(const uint64_t &key)
+{
+    size_t hole = home(key);
+    for (; slots[hole] != key; hole = (hole + 1) & mask)
+        if (slots[hole] == EMPTY)
+            return false;
+
+    // Backward-shift deletion: move every later key of the probe run whose
+    // home is not between the hole and itself into the hole
+    for (size_t i = (hole + 1) & mask; slots[i] != EMPTY; i = (i + 1) & mask)
+    {
+        size_t wanted = home(slots[i]);
+        if (((i - wanted) & mask) >= ((i - hole) & mask))
+        {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+
+    slots[hole] = EMPTY;
+    count--;
+    return true;
+}
+
+//------------------------------------ size ------------------------------------
+// Number of edges in the set
+// Preconditions: None
+// Postconditions: Returns the count of keys
+size_t EdgeSet::size() const
+{
+    return count;
+}
+
+//------------------------------- PRIVATE: resize ------------------------------
+// Rehashes into a table of the given size
+// Preconditions: size is a power of two larger than count
+// Postconditions: Every key is kept
+void EdgeSet::resize(const size_t &size)
+{
+    vector<uint64_t> old(size, EMPTY);
+    old.swap(slots);
+
+    mask = size - 1;
+    shift = 64 - __builtin_ctzll(size);
+    count = 0;
+
+    for (uint64_t key : old)
+        if (key != EMPTY)
+            insert(key);
+}
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+//  EdgeSet.h
+//------------------------------------------------------------------------------
+// EdgeSet is a flat open-addressing hash set of undirected edges. An edge
+// {u, v} is stored as the packed key u << 32 | v with u < v (see edgeKey), in
+// one array probed linearly, so a lookup is a multiply, a shift and usually a
+// single cache line. Erasing shifts the following entries back instead of
+// leaving tombstones, so the table never degrades under the long insert/erase
+// sequences of edge switching.
+//
+// ASSUMPTIONS:
+//   -- vertex IDs are below 2^32 - 1
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__EdgeSet__
+#define __NemoSQL__EdgeSet__
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+//----------------------------------- edgeKey ----------------------------------
+// Packed key of the undirected edge {u, v}
+// Preconditions: u != v, both >= 0
+// Postconditions: Returns min(u, v) << 32 | max(u, v)
+inline uint64_t edgeKey(const uint64_t &u, const uint64_t &v)
+{
+    return u < v ? u << 32 | v : v << 32 | u;
+}
+
+class EdgeSet
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates an empty set with room for capacity edges
+    // Preconditions: None
+    // Postconditions: size() == 0
+    EdgeSet(const size_t &capacity = 0);
+
+
+    //--------------------------------- contains -------------------------------
+    // Whether the set holds an edge
+    // Preconditions: key is an edgeKey
+    // Postconditions: Returns true if key is in the set
+    bool contains(const uint64_t &key) const;
+
+
+    //---------------------------------- insert --------------------------------
+    // Adds an edge
+    // Preconditions: key is an edgeKey
+    // Postconditions: Returns false if key was already in the set
+    bool insert(const uint64_t &key);
+
+
+    //---------------------------------- erase ---------------------------------
+    // Removes an edge
+    // Preconditions: key is an edgeKey
+    // Postconditions: Returns false if key was not in the set
+    bool erase(const uint64_t &key);
+
+
+    //----------------------------------- size ---------------------------------
+    // Number of edges in the set
+    // Preconditions: None
+    // Postconditions: Returns the count of keys
+    size_t size() const;
+
+
+private:
+    static const uint64_t EMPTY = UINT64_MAX;   // marks a free slot
+
+    vector<uint64_t> slots;                 // keys, EMPTY if free
+    size_t mask = 0;                        // slots.size() - 1
+    int shift = 64;                         // 64 - log2(slots.size())
+    size_t count = 0;                       // keys in the set
+
+
+    //------------------------------ PRIVATE: home -----------------------------
+    // Slot a key hashes to
+    // Preconditions: slots is not empty
+    // Postconditions: Returns a Fibonacci hash of key in [0, slots.size())
+    size_t home(const uint64_t &key) const
+    {
+        return (size_t)(key * 0x9E3779B97F4A7C15ull >> shift);
+    }
+
+
+    //----------------------------- PRIVATE: resize ----------------------------
+    // Rehashes into a table of the given size
+    // Preconditions: size is a power of two larger than count
+    // Postconditions: Every key is kept
+    void resize(const size_t &size);
+
+};
+
+#endif /* defined(__NemoSQL__EdgeSet__) */
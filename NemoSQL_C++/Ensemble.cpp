@@ -0,0 +1,335 @@
+//------------------------------------------------------------------------------
+//  Ensemble.cpp
+//------------------------------------------------------------------------------
+// Ensemble tests which size-k subgraph classes of a Graph are motifs by
+// comparing its census with those of degree-preserving random graphs.
+//
+// The random censuses are not kept: each one is folded into per-class running
+// sums as soon as it is done. A class missing from a random graph counts as
+// zero there, which the sums account for without visiting every class for
+// every graph.
+//
+// The stopping rule treats the bounds mean +- t * deviation as estimates whose
+// standard error, for roughly normal counts, is
+//     deviation * sqrt(1 / n + t^2 / (2 (n - 1)))
+// and calls a class settled when real is more than z of those errors away
+// from both bounds, z being the two-sided normal quantile of the confidence.
+// A class with the same count in every random graph is settled at once.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while an Ensemble refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "Ensemble.h"
+
+#include <cmath>
+#include <limits>
+#include "Census.h"
+#include "IncrementalCensus.h"
+#include "Random.h"
+#include "Randomizer.h"
+
+//--------------------------------- Constructor --------------------------------
+// Creates a significance test of the size-k classes of graph
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Nothing is counted yet
+Ensemble::Ensemble(const Graph &graph, const int &k)
+    : graph(graph), k(k), settled(false) {}
+
+//------------------------------- normalQuantile -------------------------------
+// Two-sided critical value of the standard normal distribution
+// Preconditions: 0 < confidence < 1
+// Postconditions: Returns z with P(|Z| <= z) = confidence
+static double normalQuantile(const double &confidence)
+{
+    double low = 0, high = 40;
+
+    // P(|Z| <= z) = erf(z / sqrt(2)) grows with z; bisect to full precision
+    for (int i = 0; i < 100; i++)
+    {
+        double middle = (low + high) / 2;
+        if (erf(middle / sqrt(2.0)) < confidence)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return (low + high) / 2;
+}
+
+//------------------------------------- run ------------------------------------
+// Counts the real graph and options.networks random graphs
+// Preconditions: options.networks >= 1, options.threads >= 1
+// Postconditions: getResults() holds one entry per class seen in the real
+//                 graph or in any random graph
+void Ensemble::run(const EnsembleOptions &options)
+{
+    CensusOptions census;
+    census.threads = options.threads;
+
+    Census counts(graph, k);
+    counts.run(census);
+    real = counts.getCounts();
+
+    networks = 0;
+    settled = false;
+    sums.clear();
+    for (const auto &entry : real)
+        sums[entry.first];
+
+    if (options.chainSwapsPerEdge > 0)
+        sampleChains(options);
+    else
+        sampleIndependent(options);
+
+    summarize();
+}
+
+//------------------------------- PRIVATE: record ------------------------------
+// Adds the census of one random graph to the running sums
+// Preconditions: counts maps every class found in that graph to its count
+// Postconditions: networks is one more; settled is set if options ask to
+//                 stop early and every call is stable
+template <class Counts>
+void Ensemble::record(const Counts &counts, const EnsembleOptions &options)
+{
+    lock_guard<mutex> lock(merge);
+
+    for (const auto &entry : counts)
+    {
+        auto found = real.find(entry.first);
+        long long inReal = found == real.end() ? 0 : found->second;
+
+        Accumulator &sum = sums[entry.first];
+        sum.sum += entry.second;
+        sum.squares += (long double)entry.second * entry.second;
+        sum.present++;
+        sum.atLeast += entry.second >= inReal;
+        sum.atMost += entry.second <= inReal;
+    }
+
+    networks++;
+
+    const bool adaptive = options.confidence > 0 && options.confidence < 1;
+    if (adaptive && networks >= max(2, options.minNetworks) &&
+        networks < options.networks && stable(options))
+        settled = true;
+}
+
+//-------------------------- PRIVATE: sampleIndependent ------------------------
+// Counts options.networks independently switched random graphs
+// Preconditions: The running sums are reset
+// Postconditions: Every counted graph is in the running sums
+void Ensemble::sampleIndependent(const EnsembleOptions &options)
+{
+    // Everything a thread needs for one random graph, kept across graphs
+    struct Slot
+    {
+        Slot(const Graph &graph, const int &k, const uint64_t &seed)
+            : randomizer(graph), worker(k, graph.size()), stream(seed) {}
+
+        Randomizer randomizer;
+        Graph random;
+        Census::Worker worker;
+        Random stream;                      // stream(seed, streamIndex)
+        int streamIndex = 0;
+    };
+
+    vector<Slot *> slots(options.threads, nullptr);
+
+    parallelFor(0, options.networks, options.threads, 1,
+                [&](int thread, int begin, int end)
+    {
+        if (slots[thread] == nullptr)
+            slots[thread] = new Slot(graph, k, options.seed);
+        Slot &slot = *slots[thread];
+
+        for (int network = begin; network < end; network++)
+        {
+            if (settled.load(memory_order_relaxed))
+                return;
+
+            // A thread's networks only increase, so its stream is jumped
+            // forward rather than rebuilt from the master seed each time
+            for (; slot.streamIndex < network; slot.streamIndex++)
+                slot.stream.jump();
+
+            slot.randomizer.reset();
+            slot.randomizer.setRandom(slot.stream);
+            slot.randomizer.randomize(options.swapsPerEdge);
+            slot.randomizer.buildGraph(slot.random);
+
+            for (int root = 0; root < slot.random.size(); root++)
+                slot.random.enumerateRoot(root, k, slot.worker,
+                                          slot.worker.state);
+
+            record(slot.worker.counts, options);
+            slot.worker.counts.clear();
+        }
+    });
+
+    for (Slot *slot : slots)
+        delete slot;
+}
+
+//---------------------------- PRIVATE: sampleChains ---------------------------
+// Counts options.networks random graphs taken from Markov chains
+// Preconditions: The running sums are reset
+// Postconditions: Every counted graph is in the running sums
+void Ensemble::sampleChains(const EnsembleOptions &options)
+{
+    const int chains = max(1, min(options.chains, options.networks));
+
+    parallelFor(0, chains, min(options.threads, chains), 1,
+                [&](int, int begin, int end)
+    {
+        for (int chain = begin; chain < end; chain++)
+        {
+            int samples = options.networks / chains +
+                          (chain < options.networks % chains ? 1 : 0);
+
+            Randomizer randomizer(graph);
+            randomizer.setRandom(Random::stream(options.seed, chain));
+            randomizer.randomize(options.swapsPerEdge);
+
+            Graph random;
+            randomizer.buildGraph(random);
+
+            IncrementalCensus census(random, k);
+            census.run(1);
+            record(census.getCounts(), options);
+
+            randomizer.record(true);
+            for (int s = 1; s < samples; s++)
+            {
+                if (settled.load(memory_order_relaxed))
+                    return;
+
+                randomizer.randomize(options.chainSwapsPerEdge);
+                census.apply(randomizer.getRemoved(), randomizer.getAdded());
+                record(census.getCounts(), options);
+            }
+        }
+    });
+}
+
+//--------------------------------- getResults ---------------------------------
+// Significance of every class found by the last run
+// Preconditions: None
+// Postconditions: Returns canonical mask -> significance
+const map<uint64_t, Significance> &Ensemble::getResults() const
+{
+    return results;
+}
+
+//--------------------------------- getNetworks --------------------------------
+// Number of random graphs behind the results
+// Preconditions: None
+// Postconditions: Returns the random graphs counted by the last run
+int Ensemble::getNetworks() const
+{
+    return networks;
+}
+
+//---------------------------------- isSettled ---------------------------------
+// Whether the last run stopped early
+// Preconditions: None
+// Postconditions: Returns true if every significance call was stable
+//                 before options.networks random graphs were counted
+bool Ensemble::isSettled() const
+{
+    return settled;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes one "graph6 real mean deviation z p" line per class
+// Preconditions: None
+// Postconditions: The results are written to out
+void Ensemble::write(ostream &out) const
+{
+    for (const auto &entry : results)
+    {
+        const Significance &s = entry.second;
+        out << Classifier::toGraph6(entry.first, k) << "\t" << s.real << "\t"
+            << s.mean << "\t" << s.deviation << "\t" << s.z << "\t" << s.p
+            << "\n";
+    }
+}
+
+//------------------------------ PRIVATE: stable -------------------------------
+// Whether every class's significance call holds at options.confidence
+// Preconditions: networks >= 2
+// Postconditions: Returns true if, for every class, real lies outside the
+//                 confidence interval of mean + threshold * deviation and
+//                 of mean - threshold * deviation; a class with zero
+//                 deviation is always settled
+bool Ensemble::stable(const EnsembleOptions &options) const
+{
+    const double z = normalQuantile(options.confidence);
+    const double t = options.threshold;
+    const double n = networks;
+
+    for (const auto &entry : sums)
+    {
+        const Accumulator &sum = entry.second;
+        auto found = real.find(entry.first);
+        double inReal = found == real.end() ? 0 : found->second;
+
+        double mean = (double)(sum.sum / n);
+        double variance = (double)(sum.squares / n) - mean * mean;
+        double deviation = sqrt(max(0.0, variance));
+
+        // A class every random graph has equally often (every k=2 census,
+        // as switches keep the edges) has no interval to be unsure about
+        if (deviation == 0)
+            continue;
+
+        double error = z * deviation * sqrt(1 / n + t * t / (2 * (n - 1)));
+
+        double upper = mean + t * deviation, lower = mean - t * deviation;
+        if (fabs(inReal - upper) <= error || fabs(inReal - lower) <= error)
+            return false;
+    }
+
+    return true;
+}
+
+//----------------------------- PRIVATE: summarize -----------------------------
+// Turns the running sums into results
+// Preconditions: None
+// Postconditions: results holds the significance of every class seen
+void Ensemble::summarize()
+{
+    results.clear();
+
+    for (const auto &entry : sums)
+    {
+        const Accumulator &sum = entry.second;
+        Significance &s = results[entry.first];
+
+        auto found = real.find(entry.first);
+        s.real = found == real.end() ? 0 : found->second;
+
+        if (networks == 0)
+            continue;
+
+        s.mean = (double)(sum.sum / networks);
+        double variance = (double)(sum.squares / networks) - s.mean * s.mean;
+        s.deviation = sqrt(max(0.0, variance));
+
+        if (s.deviation > 0)
+            s.z = (s.real - s.mean) / s.deviation;
+        else if (s.real != s.mean)
+            s.z = s.real > s.mean ? numeric_limits<double>::infinity()
+                                  : -numeric_limits<double>::infinity();
+
+        // Graphs without the class count 0, which is <= real always and
+        // >= real only when real is 0
+        int absent = networks - sum.present;
+        int atLeast = sum.atLeast + (s.real == 0 ? absent : 0);
+        int atMost = sum.atMost + absent;
+        s.p = (double)(s.real >= s.mean ? atLeast : atMost) / networks;
+    }
+}
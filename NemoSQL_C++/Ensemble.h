@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+//  Ensemble.h
+//------------------------------------------------------------------------------
+// Ensemble tests which size-k subgraph classes of a Graph are motifs: it
+// counts the classes of the real graph and of many random graphs with the same
+// degree sequence (see Randomizer), and reports per class the mean and
+// standard deviation over the random graphs, the Z-score of the real count and
+// an empirical p-value.
+//
+// The random graphs are generated and counted concurrently, one per thread at
+// a time. Every thread keeps its Randomizer, its Graph and its Census::Worker
+// (enumeration buffers and canonical-form cache) for all the graphs it
+// handles, so after the first graph a thread neither allocates much nor
+// recomputes canonical forms. Random graph i always draws from
+// Random::stream(seed, i), so the result does not depend on the number of
+// threads.
+//
+// With a confidence level set, the ensemble stops early: after every random
+// graph it checks, for each class, whether the real count lies beyond
+// mean +- threshold * deviation (a motif or anti-motif call) or within it, and
+// how sure that call is given the sampling error of the mean and deviation.
+// Once every call holds at the chosen confidence, no further graphs are
+// started. Which graphs finish before the stop depends on thread timing, so
+// early-stopped results are only reproducible with one thread.
+//
+// With chainSwapsPerEdge set, the random graphs are instead taken from Markov
+// chains run side by side on the threads: each chain starts from the real
+// graph, makes swapsPerEdge switches per edge as burn-in and counts that graph
+// in full, then makes chainSwapsPerEdge switches per edge between later
+// samples and updates the census of only the k-sets the switches touched (see
+// IncrementalCensus). Chain c draws from Random::stream(seed, c), and the
+// number of chains is an option rather than the number of threads, so chained
+// results are reproducible at any thread count too.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while an Ensemble refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Ensemble__
+#define __NemoSQL__Ensemble__
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include "Checkpoint.h"
+#include "Graph.h"
+#include "Parallel.h"
+
+using namespace std;
+
+struct EnsembleOptions
+{
+    int networks = 1000;                    // random graphs to count
+    double swapsPerEdge = 10;               // edge switches per random graph
+    int threads = defaultThreads();         // worker threads
+    uint64_t seed = 1;                      // seed of random graph 0
+    double threshold = 2;                   // |z| of a significant class
+    double confidence = 0;                  // stop once every call is this
+                                            // certain; 0 never stops early
+    int minNetworks = 20;                   // never stop before this many
+    double chainSwapsPerEdge = 0;           // switches per edge between
+                                            // samples of a chain; 0 draws
+                                            // every graph independently
+    int chains = 16;                        // Markov chains, at most networks
+};
+
+struct Significance
+{
+    long long real = 0;                     // count in the real graph
+    double mean = 0;                        // mean count in random graphs
+    double deviation = 0;                   // standard deviation of those
+    double z = 0;                           // (real - mean) / deviation
+    double p = 1;                           // share of random graphs at least
+                                            // as far from the mean as real
+};
+
+class Ensemble
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a significance test of the size-k classes of graph
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Nothing is counted yet
+    Ensemble(const Graph &graph, const int &k);
+
+
+    //----------------------------------- run ----------------------------------
+    // Counts the real graph and options.networks random graphs
+    // Preconditions: options.networks >= 1, options.threads >= 1
+    // Postconditions: getResults() holds one entry per class seen in the real
+    //                 graph or in any random graph
+    void run(const EnsembleOptions &options = EnsembleOptions());
+
+
+    //-------------------------------- getResults ------------------------------
+    // Significance of every class found by the last run
+    // Preconditions: None
+    // Postconditions: Returns canonical mask -> significance
+    const map<uint64_t, Significance> &getResults() const;
+
+
+    //-------------------------------- getNetworks -----------------------------
+    // Number of random graphs behind the results
+    // Preconditions: None
+    // Postconditions: Returns the random graphs counted by the last run
+    int getNetworks() const;
+
+
+    //-------------------------------- isSettled -------------------------------
+    // Whether the last run stopped early
+    // Preconditions: None
+    // Postconditions: Returns true if every significance call was stable
+    //                 before options.networks random graphs were counted
+    bool isSettled() const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes one "graph6 real mean deviation z p" line per class
+    // Preconditions: None
+    // Postconditions: The results are written to out
+    void write(ostream &out) const;
+
+
+private:
+    // Running sums of one class over the random graphs counted so far
+    struct Accumulator
+    {
+        long double sum = 0;                // sum of counts
+        long double squares = 0;            // sum of squared counts
+        int present = 0;                    // graphs with the class
+        int atLeast = 0;                    // present with count >= real
+        int atMost = 0;                     // present with count <= real
+    };
+
+    const Graph &graph;                     // the real graph
+    int k;                                  // subgraph size
+    int networks = 0;                       // random graphs counted
+    atomic<bool> settled;                   // every call is stable
+    mutex merge;                            // guards the running sums
+    ClassCounts real;                       // census of the real graph
+    map<uint64_t, Accumulator> sums;        // class -> running sums
+    map<uint64_t, Significance> results;    // result of run
+
+
+    //----------------------- PRIVATE: sampleIndependent -----------------------
+    // Counts options.networks independently switched random graphs
+    // Preconditions: The running sums are reset
+    // Postconditions: Every counted graph is in the running sums
+    void sampleIndependent(const EnsembleOptions &options);
+
+
+    //--------------------------- PRIVATE: sampleChains ------------------------
+    // Counts options.networks random graphs taken from Markov chains
+    // Preconditions: The running sums are reset
+    // Postconditions: Every counted graph is in the running sums
+    void sampleChains(const EnsembleOptions &options);
+
+
+    //----------------------------- PRIVATE: record ----------------------------
+    // Adds the census of one random graph to the running sums
+    // Preconditions: counts maps every class found in that graph to its count
+    // Postconditions: networks is one more; settled is set if options ask to
+    //                 stop early and every call is stable
+    template <class Counts>
+    void record(const Counts &counts, const EnsembleOptions &options);
+
+
+    //---------------------------- PRIVATE: stable -----------------------------
+    // Whether every class's significance call holds at options.confidence
+    // Preconditions: networks >= 2
+    // Postconditions: Returns true if, for every class, real lies outside the
+    //                 confidence interval of mean + threshold * deviation and
+    //                 of mean - threshold * deviation; a class with zero
+    //                 deviation is always settled
+    bool stable(const EnsembleOptions &options) const;
+
+
+    //--------------------------- PRIVATE: summarize ---------------------------
+    // Turns the running sums into results
+    // Preconditions: None
+    // Postconditions: results holds the significance of every class seen
+    void summarize();
+
+};
+
+#endif /* defined(__NemoSQL__Ensemble__) */
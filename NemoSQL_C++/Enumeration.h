@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+//  Enumeration.h
+//------------------------------------------------------------------------------
+// Types shared by the subgraph enumeration of Graph and its callers.
+//
+// A visitor is any type with a member
+//
+//     void visit(const int *subgraph, const int &k, const uint64_t &mask);
+//
+// which Graph::enumerateSubgraph calls once per connected size-k subgraph.
+// subgraph holds the k vertex IDs (first the root, the smallest ID) and mask is
+// their packed adjacency (see Classifier.h). Because enumerateSubgraph is a
+// template over the visitor type, visit is resolved at compile time and
+// inlined into the enumeration loop.
+//
+// A batch sink is any type with a member
+//
+//     void visitBatch(const int *subgraphs, const uint64_t *masks,
+//                     const int &count, const int &k);
+//
+// where subgraphs holds count instances of k vertices back to back. Wrapping a
+// sink in a BatchVisitor buffers instances and hands them over BATCH_SIZE at a
+// time, which amortizes calls that cannot be inlined (std::function, virtual
+// calls, I/O).
+//
+// A visitor may also have a member
+//
+//     void visitRows(const int *prefix, const int &k, const uint64_t &mask,
+//                    const uint32_t *rows, const int *counts,
+//                    const int &distinct);
+//
+// and then the leaves under a prefix of k-1 vertices (packed adjacency mask)
+// are not visited one by one: the last vertex of a leaf only adds its
+// adjacency row to the prefix (bit i: adjacent to prefix[i]), so the leaves
+// are tallied by row and handed over at once, counts[i] leaves with row
+// rows[i] for the distinct rows found. A leaf's mask is mask | rows[i] <<
+// (k-1)*(k-2)/2. A counting visitor then classifies each distinct row once
+// instead of each leaf, and there are at most 2^(k-1) rows, usually far fewer
+// than the leaves of the prefix.
+//
+// ASSUMPTIONS:
+//   -- the pointers handed to visit and visitBatch are only valid during the
+//      call; visitors that keep instances must copy them
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Enumeration__
+#define __NemoSQL__Enumeration__
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include "Stats.h"
+
+using namespace std;
+
+const int BATCH_SIZE = 1024;                // instances per visitBatch call
+const uint32_t IN_SEED = 1u << 31;          // adjacent[] mark of seed vertices
+const uint32_t EXCLUDED = 1u << 30;         // adjacent[] mark of left-out ones
+
+//------------------------------------------------------------------------------
+// Per-thread working memory of one enumeration. Everything is sized once by
+// reset, so walking a root does not allocate after the extension buffers have
+// grown to the largest neighborhood seen.
+struct EnumerationState
+{
+    vector<int> subgraph;                   // vertices of the current prefix
+    vector<vector<int>> extension;          // extension set of every depth
+    vector<uint32_t> adjacent;              // bit i: adjacent to subgraph[i]
+    vector<int> tally;                      // leaves per row, all 0 between
+    vector<uint32_t> rows;                  // distinct rows of a prefix
+    vector<int> rowCounts;                  // leaves of each of them
+    EngineStats stats;                      // filled only with NEMO_STATS
+
+    //---------------------------------- reset ---------------------------------
+    // Sizes the buffers for size-k subgraphs of an n-vertex graph
+    // Preconditions: None
+    // Postconditions: No vertex is marked as adjacent to the subgraph
+    void reset(const int &k, const int &n)
+    {
+        subgraph.assign(k, -1);
+        extension.resize(k);
+        adjacent.assign(n, 0);
+        tally.assign((size_t)1 << (k - 1), 0);
+        rows.resize(tally.size());
+        rowCounts.resize(tally.size());
+    }
+};
+
+//------------------------------------------------------------------------------
+// Whether a visitor takes the leaves of a prefix as tallied rows (visitRows)
+template <class Visitor, class = void>
+struct TakesRows : false_type {};
+
+template <class Visitor>
+struct TakesRows<Visitor, decltype(void(&Visitor::visitRows))> : true_type {};
+
+//------------------------------------------------------------------------------
+// Counts instances without looking at them
+class CountVisitor
+{
+public:
+    long long count = 0;                    // number of instances visited
+
+    void visit(const int *, const int &, const uint64_t &)
+    {
+        count++;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Buffers instances and forwards them to a batch sink BATCH at a time
+template <class Sink, int BATCH = BATCH_SIZE>
+class BatchVisitor
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a buffer of BATCH size-k instances in front of sink
+    // Preconditions: sink outlives the BatchVisitor
+    // Postconditions: The buffer is empty
+    BatchVisitor(Sink &sink, const int &k)
+        : sink(sink), k(k), vertices(BATCH * k) {}
+
+    //------------------------------- Destructor -------------------------------
+    // Hands the instances still buffered to the sink
+    // Preconditions: None
+    // Postconditions: The buffer is flushed
+    ~BatchVisitor()
+    {
+        flush();
+    }
+
+    //---------------------------------- visit ---------------------------------
+    // Buffers one instance, flushing when the buffer is full
+    // Preconditions: subgraph holds k vertices
+    // Postconditions: The instance is buffered or already handed to the sink
+    void visit(const int *subgraph, const int &, const uint64_t &mask)
+    {
+        copy(subgraph, subgraph + k, vertices.begin() + count * k);
+        masks[count] = mask;
+
+        if (++count == BATCH)
+            flush();
+    }
+
+    //---------------------------------- flush ---------------------------------
+    // Hands every buffered instance to the sink
+    // Preconditions: None
+    // Postconditions: The buffer is empty
+    void flush()
+    {
+        if (count == 0)
+            return;
+
+        sink.visitBatch(vertices.data(), masks, count, k);
+        count = 0;
+    }
+
+private:
+    Sink &sink;                             // receiver of full batches
+    int k;                                  // subgraph size
+    int count = 0;                          // instances in the buffer
+    vector<int> vertices;                   // BATCH instances of k vertices
+    uint64_t masks[BATCH];                  // packed adjacency of each one
+};
+
+//------------------------------------------------------------------------------
+// Runtime callback over batches of instances, for callers that cannot be
+// templates (e.g. across a library boundary)
+typedef function<void(const int *subgraphs, const uint64_t *masks,
+                      const int &count, const int &k)> BatchCallback;
+
+class CallbackSink
+{
+public:
+    CallbackSink(const BatchCallback &callback) : callback(callback) {}
+
+    void visitBatch(const int *subgraphs, const uint64_t *masks,
+                    const int &count, const int &k)
+    {
+        callback(subgraphs, masks, count, k);
+    }
+
+private:
+    const BatchCallback &callback;          // function called per batch
+};
+
+#endif /* defined(__NemoSQL__Enumeration__) */
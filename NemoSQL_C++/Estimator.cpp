@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+//  Estimator.cpp
+//------------------------------------------------------------------------------
+// Estimator predicts the size of a census before running it, following
+// random root-to-leaf paths of the ESU tree (Knuth's estimator) and timing
+// the real enumeration on a sample of roots.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while an Estimator refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "Estimator.h"
+
+#include <algorithm>
+#include <chrono>
+#include "Census.h"
+
+// Roots predicted to hold more subgraphs than this are too slow to time
+const double CALIBRATION_LEAVES = 1e6;
+
+//--------------------------------- Constructor --------------------------------
+// Creates an estimator for the size-k census of graph
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Random probes are drawn from a generator seeded by seed
+Estimator::Estimator(const Graph &graph, const int &k, const uint64_t &seed)
+    : graph(graph), k(k), random(seed)
+{
+    state.reset(k, graph.size());
+}
+
+//---------------------------------- estimate ----------------------------------
+// Predicts the census size and runtime
+// Preconditions: probes >= 1, calibrationSeconds >= 0
+// Postconditions: Returns probes random paths' worth of prediction per root,
+//                 with the rate measured over at most calibrationSeconds
+Estimate Estimator::estimate(const int &probes,
+                             const double &calibrationSeconds)
+{
+    Estimate result;
+    result.rootLeaves.assign(graph.size(), 0);
+
+    for (int root = 0; root < graph.size(); root++)
+    {
+        if (graph.neighbors(root).empty())
+            continue;
+
+        double sum = 0;
+        for (int p = 0; p < probes; p++)
+            sum += probe(root);
+
+        result.rootLeaves[root] = sum / probes;
+        result.leaves += result.rootLeaves[root];
+    }
+
+    result.leavesPerSecond = calibrate(result.rootLeaves, calibrationSeconds);
+    if (result.leavesPerSecond > 0)
+        result.seconds = result.leaves / result.leavesPerSecond;
+
+    return result;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes a one-line summary of estimate
+// Preconditions: None
+// Postconditions: Leaves, rate and predicted runtime are written to out
+void Estimator::write(ostream &out, const Estimate &estimate)
+{
+    out << "Estimated subgraphs = " << (long long)estimate.leaves
+        << ", rate = " << (long long)estimate.leavesPerSecond << "/s"
+        << ", single-thread time = " << estimate.seconds << " s" << endl;
+}
+
+//-------------------------------- PRIVATE: probe ------------------------------
+// Follows one random path of the ESU tree of root
+// Preconditions: state.adjacent is all zero
+// Postconditions: Returns the Knuth estimate of the leaves under root;
+//                 state.adjacent is all zero again
+double Estimator::probe(const int &root)
+{
+    state.subgraph[0] = root;
+
+    vector<int> &first = state.extension[1];
+    first.clear();
+    for (int w : graph.neighbors(root))
+    {
+        state.adjacent[w] |= 1;
+        if (w > root)
+            first.push_back(w);
+    }
+
+    // Child i of a node takes w = extension[i] and keeps extension[0..i),
+    // which is what the enumeration sees after popping the ones behind it
+    double weight = 1;
+    int depth = 1;
+    for (; depth < k - 1; depth++)
+    {
+        vector<int> &extension = state.extension[depth];
+        if (extension.empty())
+        {
+            weight = 0;
+            break;
+        }
+
+        weight *= extension.size();
+        size_t i = random.uniform(extension.size());
+        int w = extension[i];
+
+        vector<int> &next = state.extension[depth + 1];
+        next.assign(extension.begin(), extension.begin() + i);
+        for (int vertex : graph.neighbors(w))
+            if (vertex > root && state.adjacent[vertex] == 0)
+                next.push_back(vertex);
+
+        state.subgraph[depth] = w;
+        for (int vertex : graph.neighbors(w))
+            state.adjacent[vertex] |= 1u << depth;
+    }
+
+    if (depth == k - 1)
+        weight *= state.extension[depth].size();
+
+    for (int d = 0; d < depth; d++)
+        for (int vertex : graph.neighbors(state.subgraph[d]))
+            state.adjacent[vertex] &= ~(1u << d);
+
+    return weight;
+}
+
+//------------------------------ PRIVATE: calibrate ----------------------------
+// Enumerates random roots for about seconds and measures leaves per second
+// Preconditions: rootLeaves holds the predicted leaves of every root
+// Postconditions: Returns the measured rate, 0 if nothing was enumerated
+double Estimator::calibrate(const vector<double> &rootLeaves,
+                            const double &seconds)
+{
+    typedef chrono::steady_clock Clock;
+    const auto start = Clock::now();
+    double leaves = 0, elapsed = 0;
+    // The census's own worker, so the rate is that of the engine that runs
+    Census::Worker worker(k, graph.size());
+
+    // Only roots cheap enough to finish within the budget are timed
+    for (int tries = 0; tries < graph.size() && elapsed < seconds; tries++)
+    {
+        int root = (int)random.uniform(graph.size());
+        if (rootLeaves[root] == 0 || rootLeaves[root] > CALIBRATION_LEAVES)
+            continue;
+
+        graph.enumerateRoot(root, k, worker, worker.state);
+
+        for (const auto &entry : worker.counts)
+            leaves += entry.second;
+        worker.counts.clear();
+        elapsed = chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    return elapsed > 0 && leaves > 0 ? leaves / elapsed : 0;
+}
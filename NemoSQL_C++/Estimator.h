@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+//  Estimator.h
+//------------------------------------------------------------------------------
+// Estimator predicts the size of a census before running it. For every root
+// it follows random root-to-leaf paths of the ESU tree (Knuth's estimator):
+// the product of the branching factors along a path times the number of
+// leaves at its end is an unbiased estimate of the number of size-k subgraphs
+// under that root. A short timed census of a sample of roots turns the
+// predicted leaves into seconds.
+// features are included:
+//   -- predicted subgraphs of every root and in total
+//   -- predicted single-thread runtime
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while an Estimator refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Estimator__
+#define __NemoSQL__Estimator__
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Enumeration.h"
+#include "Graph.h"
+#include "Random.h"
+
+using namespace std;
+
+struct Estimate
+{
+    double leaves = 0;                      // predicted size-k subgraphs
+    double leavesPerSecond = 0;             // measured enumeration rate
+    double seconds = 0;                     // predicted single-thread runtime
+    vector<double> rootLeaves;              // predicted subgraphs per root
+};
+
+class Estimator
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates an estimator for the size-k census of graph
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Random probes are drawn from a generator seeded by seed
+    Estimator(const Graph &graph, const int &k, const uint64_t &seed = 1);
+
+
+    //--------------------------------- estimate -------------------------------
+    // Predicts the census size and runtime
+    // Preconditions: probes >= 1, calibrationSeconds >= 0
+    // Postconditions: Returns probes random paths' worth of prediction per root,
+    //                 with the rate measured over at most calibrationSeconds
+    Estimate estimate(const int &probes = 16,
+                      const double &calibrationSeconds = 0.1);
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes a one-line summary of estimate
+    // Preconditions: None
+    // Postconditions: Leaves, rate and predicted runtime are written to out
+    static void write(ostream &out, const Estimate &estimate);
+
+
+private:
+    const Graph &graph;                     // graph being estimated
+    int k;                                  // subgraph size
+    Random random;                          // source of the random paths
+    EnumerationState state;                 // buffers of one path
+
+
+    //----------------------------- PRIVATE: probe -----------------------------
+    // Follows one random path of the ESU tree of root
+    // Preconditions: state.adjacent is all zero
+    // Postconditions: Returns the Knuth estimate of the leaves under root;
+    //                 state.adjacent is all zero again
+    double probe(const int &root);
+
+    //--------------------------- PRIVATE: calibrate ---------------------------
+    // Enumerates random roots for about seconds and measures leaves per second
+    // Preconditions: rootLeaves holds the predicted leaves of every root
+    // Postconditions: Returns the measured rate, 0 if nothing was enumerated
+    double calibrate(const vector<double> &rootLeaves, const double &seconds);
+
+};
+
+#endif /* defined(__NemoSQL__Estimator__) */
@@ -60,6 +60,30 @@ void Graph::buildGraph(ifstream& infile)
     }
 }
 
+//--------------------------------- buildGraph ---------------------------------
+// Builds a graph from packed edges u << 32 | v (see EdgeSet.h)
+// Preconditions:  Every edge joins two different vertices
+// Postconditions: The graph holds exactly these edges; size() is the
+//                 larger of n and the largest vertex ID + 1. The adjacency
+//                 sets of a previous graph are reused
+void Graph::buildGraph(const vector<uint64_t> &edges, const int &n)
+{
+    for (unordered_set<int> &adjacency : vertices)
+        adjacency.clear();
+    vertices.resize(n);
+    
+    for (uint64_t edge : edges)
+    {
+        int src = (int)(edge >> 32), dest = (int)(edge & 0xffffffff);
+        
+        exist(src);
+        exist(dest);
+        
+        vertices[src].insert(dest);
+        vertices[dest].insert(src);
+    }
+}
+
 //------------------------------- PRIVATE: exist -------------------------------
 // Check if vertex already exists in the vector vertices
 // Preconditions: None
@@ -104,10 +128,20 @@ void Graph::display() const
 // Preconditions: The graph should have already been built or exists
 // Postcondition: The list of subgraphs are displayed
 void Graph::enumerateSubgraph(const int &k)
+{
+    cerr << countSubgraphs(k) << endl;
+}
+
+//------------------------------- countSubgraphs -------------------------------
+// Count size-k subgraphs of the original graph without printing them
+// Preconditions: The graph should have already been built or exists
+// Postcondition: Returns the number of connected size-k subgraphs found by
+//                the original enumeration
+long long Graph::countSubgraphs(const int &k)
 {
     count = 0;
     
-    for(int i = 0; i <= vertices.size(); i++)
+    for(int i = 0; i < size(); i++)
     {
         if(vertices[i].size() > 0)
         {
@@ -123,7 +157,80 @@ void Graph::enumerateSubgraph(const int &k)
             extendSubgraph(Vsubgraph, Vextension, visited, i, k);
         }
     }
-    cerr << count << endl;
+    return count;
+}
+
+//-------------------------- enumerateSubgraphBatches --------------------------
+// Enumerate size-k subgraphs and hand them to callback in batches
+// Preconditions: The graph should have already been built or exists;
+//                2 <= k <= MAX_SUBGRAPH_SIZE
+// Postcondition: callback was called with every connected size-k subgraph,
+//                up to BATCH_SIZE instances per call
+void Graph::enumerateSubgraphBatches(const int &k,
+                                     const BatchCallback &callback) const
+{
+    CallbackSink sink(callback);
+    BatchVisitor<CallbackSink> batches(sink, k);
+    
+    enumerateSubgraph(k, batches);
+}
+
+//----------------------------------- addEdge ----------------------------------
+// Adds an edge between vertex u and vertex v
+// Preconditions: u != v, both >= 0
+// Postconditions: Returns false if the edge already existed; size() grows
+//                 to cover both vertices
+bool Graph::addEdge(const int &u, const int &v)
+{
+    exist(u);
+    exist(v);
+    
+    if (!vertices[u].insert(v).second)
+        return false;
+    
+    vertices[v].insert(u);
+    return true;
+}
+
+//---------------------------------- removeEdge --------------------------------
+// Removes the edge between vertex u and vertex v
+// Preconditions: None
+// Postconditions: Returns false if there was no such edge
+bool Graph::removeEdge(const int &u, const int &v)
+{
+    if (u < 0 || v < 0 || u >= size() || v >= size() ||
+        vertices[u].erase(v) == 0)
+        return false;
+    
+    vertices[v].erase(u);
+    return true;
+}
+
+//------------------------------------ size ------------------------------------
+// Number of vertex slots in the adjacency list (largest vertex ID + 1)
+// Preconditions: None
+// Postconditions: Returns the size of the vector vertices
+int Graph::size() const
+{
+    return (int)vertices.size();
+}
+
+//---------------------------------- neighbors ---------------------------------
+// Neighbors of the given vertex
+// Preconditions: 0 <= vertex < size()
+// Postconditions: Returns the adjacency set of vertex
+const unordered_set<int> &Graph::neighbors(const int &vertex) const
+{
+    return vertices[vertex];
+}
+
+//----------------------------------- isEdge -----------------------------------
+// Check if vertex u and vertex v are connected
+// Preconditions: 0 <= u, v < size()
+// Postconditions: Returns true if there is an edge between u and v
+bool Graph::isEdge(const int &u, const int &v) const
+{
+    return vertices[u].count(v) != 0;
 }
 
 //--------------------------- PRIVATE: getExtension ----------------------------
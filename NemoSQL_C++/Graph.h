@@ -26,6 +26,7 @@
 #include <list>
 #include <unordered_set>
 #include <climits>
+#include "Enumeration.h"
 
 using namespace std;
 
@@ -54,6 +55,15 @@ public:
     void buildGraph(ifstream &infile);
     
     
+    //------------------------------- buildGraph -------------------------------
+    // Builds a graph from packed edges u << 32 | v (see EdgeSet.h)
+    // Preconditions:  Every edge joins two different vertices
+    // Postconditions: The graph holds exactly these edges; size() is the
+    //                 larger of n and the largest vertex ID + 1. The adjacency
+    //                 sets of a previous graph are reused
+    void buildGraph(const vector<uint64_t> &edges, const int &n);
+    
+    
     //-------------------------------- display ---------------------------------
     // Display a all detailed path
     // Preconditions: vertices[vertexFrom] and its data must exist
@@ -68,8 +78,110 @@ public:
     void enumerateSubgraph(const int &k);
     
     
+    //----------------------------- countSubgraphs -----------------------------
+    // Count size-k subgraphs of the original graph without printing them
+    // Preconditions: The graph should have already been built or exists
+    // Postcondition: Returns the number of connected size-k subgraphs found
+    //                by the original enumeration
+    long long countSubgraphs(const int &k);
+    
+    
+    //--------------------------- enumerateSubgraph ----------------------------
+    // Enumerate size-k subgraphs and hand each one to a visitor
+    // Preconditions: The graph should have already been built or exists;
+    //                2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postcondition: visitor.visit was called once per connected size-k
+    //                subgraph (see Enumeration.h)
+    template <class Visitor>
+    void enumerateSubgraph(const int &k, Visitor &visitor) const;
+    
+    
+    //------------------------ enumerateSubgraphBatches ------------------------
+    // Enumerate size-k subgraphs and hand them to callback in batches
+    // Preconditions: The graph should have already been built or exists;
+    //                2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postcondition: callback was called with every connected size-k subgraph,
+    //                up to BATCH_SIZE instances per call
+    void enumerateSubgraphBatches(const int &k,
+                                  const BatchCallback &callback) const;
+    
+    
+    //----------------------------- enumerateRoot ------------------------------
+    // Enumerate the size-k subgraphs whose smallest vertex is root
+    // Preconditions: state was reset for k and size(); 0 <= root < size()
+    // Postcondition: visitor.visit was called once per connected size-k
+    //                subgraph containing root and no vertex smaller than root,
+    //                and with EVERY_SIZE also once per such subgraph of each
+    //                size 2..k-1 (with that size as k); state is ready for
+    //                the next root
+    template <class Visitor, bool EVERY_SIZE = false>
+    void enumerateRoot(const int &root, const int &k, Visitor &visitor,
+                       EnumerationState &state) const;
+    
+    
+    //---------------------------- enumerateSeeded -----------------------------
+    // Enumerate the size-k subgraphs that contain every vertex of seed
+    // Preconditions: state was reset for k and size(); the seedSize distinct
+    //                vertices of seed induce a connected subgraph
+    // Postcondition: visitor.visit was called once per connected size-k
+    //                subgraph containing the seed, which comes first in the
+    //                vertices handed to visit; state is ready for reuse
+    template <class Visitor>
+    void enumerateSeeded(const int *seed, const int &seedSize, const int &k,
+                         Visitor &visitor, EnumerationState &state) const;
+    
+    
+    //---------------------------- enumerateAround -----------------------------
+    // Enumerate the size-k subgraphs that contain at least one vertex of seeds
+    // Preconditions: state was reset for k and size(); the seedCount vertices
+    //                of seeds are distinct
+    // Postcondition: visitor.visit was called once per connected size-k
+    //                subgraph containing a seed, with the first of its seeds
+    //                (in the order of seeds) first in the vertices handed to
+    //                visit; state is ready for reuse
+    template <class Visitor>
+    void enumerateAround(const int *seeds, const int &seedCount, const int &k,
+                         Visitor &visitor, EnumerationState &state) const;
+    
+    
+    //--------------------------------- addEdge --------------------------------
+    // Adds an edge between vertex u and vertex v
+    // Preconditions: u != v, both >= 0
+    // Postconditions: Returns false if the edge already existed; size() grows
+    //                 to cover both vertices
+    bool addEdge(const int &u, const int &v);
+    
+    
+    //------------------------------- removeEdge -------------------------------
+    // Removes the edge between vertex u and vertex v
+    // Preconditions: None
+    // Postconditions: Returns false if there was no such edge
+    bool removeEdge(const int &u, const int &v);
+    
+    
+    //---------------------------------- size ----------------------------------
+    // Number of vertex slots in the adjacency list (largest vertex ID + 1)
+    // Preconditions: None
+    // Postconditions: Returns the size of the vector vertices
+    int size() const;
+    
+    
+    //------------------------------- neighbors --------------------------------
+    // Neighbors of the given vertex
+    // Preconditions: 0 <= vertex < size()
+    // Postconditions: Returns the adjacency set of vertex
+    const unordered_set<int> &neighbors(const int &vertex) const;
+    
+    
+    //--------------------------------- isEdge ---------------------------------
+    // Check if vertex u and vertex v are connected
+    // Preconditions: 0 <= u, v < size()
+    // Postconditions: Returns true if there is an edge between u and v
+    bool isEdge(const int &u, const int &v) const;
+    
+    
 private:
-    int count = 0;                          // count number of motif found
+    long long count = 0;                    // count number of motif found
     vector<unordered_set<int>> vertices;            // adjacency list
     
     
@@ -93,7 +205,285 @@ private:
     // Postcondition: All neighbors of vertex are added to Vextension
     void getExtension(unordered_set<int> &Vextension, const int &vertex);
     
+    //-------------------------- PRIVATE: visitLeaves --------------------------
+    // Visits the leaves under the k-1 vertices in state.subgraph, whose packed
+    // adjacency is mask: the vertices of state.extension[k-1]
+    // Precondition: state.adjacent marks the neighbors of the prefix
+    // Postcondition: Every leaf was handed to visitor.visit, or as a tallied
+    //                row to visitor.visitRows for visitors that have it (see
+    //                Enumeration.h); state.extension[k-1] is empty
+    template <class Visitor>
+    void visitLeaves(EnumerationState &state, const int &k,
+                     const uint64_t &mask, Visitor &visitor, false_type) const;
+    template <class Visitor>
+    void visitLeaves(EnumerationState &state, const int &k,
+                     const uint64_t &mask, Visitor &visitor, true_type) const;
+    
+    //------------------------- PRIVATE: extendPrefix --------------------------
+    // Recursively extends the depth vertices in state.subgraph, whose packed
+    // adjacency is mask, by the vertices of state.extension[depth]
+    // Precondition: state.adjacent marks the neighbors of the prefix
+    // Postcondition: Every size-k subgraph under this prefix was visited, and
+    //                with EVERY_SIZE the prefix and every smaller one under
+    //                it; state.extension[depth] is empty
+    template <class Visitor, bool EVERY_SIZE = false>
+    void extendPrefix(EnumerationState &state, const int &depth,
+                      const int &root, const int &k, const uint64_t &mask,
+                      Visitor &visitor) const;
     
 };
 
+//------------------------------ enumerateSubgraph -----------------------------
+// Enumerate size-k subgraphs and hand each one to a visitor
+// Preconditions: The graph should have already been built or exists;
+//                2 <= k <= MAX_SUBGRAPH_SIZE
+// Postcondition: visitor.visit was called once per connected size-k
+//                subgraph (see Enumeration.h)
+template <class Visitor>
+void Graph::enumerateSubgraph(const int &k, Visitor &visitor) const
+{
+    EnumerationState state;
+    state.reset(k, size());
+    
+    for(int i = 0; i < size(); i++)
+        enumerateRoot(i, k, visitor, state);
+}
+
+//-------------------------------- enumerateRoot -------------------------------
+// Enumerate the size-k subgraphs whose smallest vertex is root
+// Preconditions: state was reset for k and size(); 0 <= root < size()
+// Postcondition: visitor.visit was called once per connected size-k
+//                subgraph containing root and no vertex smaller than root,
+//                and with EVERY_SIZE also once per such subgraph of each size
+//                2..k-1 (with that size as k); state is ready for the next
+//                root
+template <class Visitor, bool EVERY_SIZE>
+void Graph::enumerateRoot(const int &root, const int &k, Visitor &visitor,
+                          EnumerationState &state) const
+{
+    if(vertices[root].empty())
+        return;
+    
+    state.subgraph[0] = root;
+    
+    vector<int> &Vextension = state.extension[1];
+    Vextension.clear();
+    for (int w : vertices[root])
+    {
+        state.adjacent[w] |= 1;
+        if (w > root)
+            Vextension.push_back(w);
+    }
+    
+    STATS(long long before = state.stats.nodes[k]);
+    
+    extendPrefix<Visitor, EVERY_SIZE>(state, 1, root, k, 0, visitor);
+    
+    STATS(state.stats.roots++);
+    STATS(state.stats.rootLeaves[EngineStats::bucket(state.stats.nodes[k] -
+                                                     before)]++);
+    
+    for (int w : vertices[root])
+        state.adjacent[w] &= ~1u;
+}
+
+//------------------------------- enumerateSeeded ------------------------------
+// Enumerate the size-k subgraphs that contain every vertex of seed
+// Preconditions: state was reset for k and size(); the seedSize distinct
+//                vertices of seed induce a connected subgraph
+// Postcondition: visitor.visit was called once per connected size-k
+//                subgraph containing the seed, which comes first in the
+//                vertices handed to visit; state is ready for reuse
+template <class Visitor>
+void Graph::enumerateSeeded(const int *seed, const int &seedSize, const int &k,
+                            Visitor &visitor, EnumerationState &state) const
+{
+    if(seedSize > k)
+        return;
+    
+    uint64_t mask = 0;
+    for (int i = 0; i < seedSize; i++)
+    {
+        state.subgraph[i] = seed[i];
+        for (int j = 0; j < i; j++)
+            if (isEdge(seed[j], seed[i]))
+                mask |= (uint64_t)1 << pairBit(j, i);
+    }
+    
+    if(seedSize == k)
+    {
+        visitor.visit(state.subgraph.data(), k, mask);
+        return;
+    }
+    
+    // The seed acts as one contracted root: its vertices are marked as taken
+    // so they never count as exclusive neighbors, and with no smaller-root
+    // rule (root -1) every connected superset is reached exactly once
+    for (int i = 0; i < seedSize; i++)
+        state.adjacent[seed[i]] |= IN_SEED;
+    
+    vector<int> &Vextension = state.extension[seedSize];
+    Vextension.clear();
+    for (int i = 0; i < seedSize; i++)
+        for (int w : vertices[seed[i]])
+        {
+            if (state.adjacent[w] == 0)
+                Vextension.push_back(w);
+            state.adjacent[w] |= 1u << i;
+        }
+    
+    extendPrefix(state, seedSize, -1, k, mask, visitor);
+    
+    for (int i = 0; i < seedSize; i++)
+        for (int w : vertices[seed[i]])
+            state.adjacent[w] &= ~(1u << i);
+    for (int i = 0; i < seedSize; i++)
+        state.adjacent[seed[i]] &= ~IN_SEED;
+}
+
+//------------------------------- enumerateAround ------------------------------
+// Enumerate the size-k subgraphs that contain at least one vertex of seeds
+// Preconditions: state was reset for k and size(); the seedCount vertices of
+//                seeds are distinct
+// Postcondition: visitor.visit was called once per connected size-k
+//                subgraph containing a seed, with the first of its seeds (in
+//                the order of seeds) first in the vertices handed to visit;
+//                state is ready for reuse
+template <class Visitor>
+void Graph::enumerateAround(const int *seeds, const int &seedCount,
+                            const int &k, Visitor &visitor,
+                            EnumerationState &state) const
+{
+    // Seed i only takes the subgraphs without the seeds before it: those are
+    // marked so they never enter an extension set, which leaves the search
+    // of the graph without them, so a subgraph is found from its first seed
+    for (int i = 0; i < seedCount; i++)
+    {
+        enumerateSeeded(seeds + i, 1, k, visitor, state);
+        state.adjacent[seeds[i]] |= EXCLUDED;
+    }
+    
+    for (int i = 0; i < seedCount; i++)
+        state.adjacent[seeds[i]] &= ~EXCLUDED;
+}
+
+//---------------------------- PRIVATE: visitLeaves ----------------------------
+// Visits the leaves under the k-1 vertices in state.subgraph one by one
+// Precondition: state.adjacent marks the neighbors of the prefix
+// Postcondition: Every leaf was handed to visitor.visit and
+//                state.extension[k-1] is empty
+template <class Visitor>
+void Graph::visitLeaves(EnumerationState &state, const int &k,
+                        const uint64_t &mask, Visitor &visitor,
+                        false_type) const
+{
+    vector<int> &Vextension = state.extension[k-1];
+    const int offset = (k - 1) * (k - 2) / 2;
+    
+    for(int w : Vextension)
+    {
+        state.subgraph[k-1] = w;
+        visitor.visit(state.subgraph.data(), k,
+                      mask | (uint64_t)state.adjacent[w] << offset);
+    }
+    Vextension.clear();
+}
+
+//---------------------------- PRIVATE: visitLeaves ----------------------------
+// Hands the leaves under the k-1 vertices in state.subgraph to the visitor
+// tallied by adjacency row
+// Precondition: state.adjacent marks the neighbors of the prefix; state.tally
+//               is all zero
+// Postcondition: visitor.visitRows was called once with every distinct row
+//                and its number of leaves; state.tally is all zero and
+//                state.extension[k-1] is empty
+template <class Visitor>
+void Graph::visitLeaves(EnumerationState &state, const int &k,
+                        const uint64_t &mask, Visitor &visitor,
+                        true_type) const
+{
+    vector<int> &Vextension = state.extension[k-1];
+    const uint32_t prefix = (1u << (k - 1)) - 1;
+    int *tally = state.tally.data();
+    uint32_t *rows = state.rows.data();
+    int distinct = 0;
+    
+    // One gather and one increment per leaf; no classification
+    for(int w : Vextension)
+    {
+        uint32_t row = state.adjacent[w] & prefix;
+        if(tally[row]++ == 0)
+            rows[distinct++] = row;
+    }
+    Vextension.clear();
+    
+    for(int i = 0; i < distinct; i++)
+    {
+        state.rowCounts[i] = tally[rows[i]];
+        tally[rows[i]] = 0;
+    }
+    
+    visitor.visitRows(state.subgraph.data(), k, mask, rows,
+                      state.rowCounts.data(), distinct);
+}
+
+//---------------------------- PRIVATE: extendPrefix ---------------------------
+// Recursively extends the depth vertices in state.subgraph, whose packed
+// adjacency is mask, by the vertices of state.extension[depth]
+// Precondition: state.adjacent marks the neighbors of the prefix
+// Postcondition: Every size-k subgraph under this prefix was visited, and
+//                with EVERY_SIZE the prefix and every smaller one under it;
+//                state.extension[depth] is empty
+template <class Visitor, bool EVERY_SIZE>
+void Graph::extendPrefix(EnumerationState &state, const int &depth,
+                         const int &root, const int &k, const uint64_t &mask,
+                         Visitor &visitor) const
+{
+    vector<int> &Vextension = state.extension[depth];
+    const int offset = depth * (depth - 1) / 2;
+    
+    STATS(state.stats.nodes[depth]++);
+    STATS(state.stats.extensionSizes[EngineStats::bucket(Vextension.size())]++);
+    
+    // Every search-tree node is a distinct connected subgraph of its depth
+    if(EVERY_SIZE && depth >= 2)
+        visitor.visit(state.subgraph.data(), depth, mask);
+    
+    // The last vertex only adds its adjacency row to the prefix
+    if(depth == k-1)
+    {
+        STATS(state.stats.nodes[k] += Vextension.size());
+        
+        visitLeaves(state, k, mask, visitor, TakesRows<Visitor>());
+        return;
+    }
+    
+    while(!Vextension.empty())
+    {
+        int w = Vextension.back();
+        Vextension.pop_back();
+        
+        // Vertices not yet next to the prefix are the exclusive neighbors of w
+        vector<int> &Vextension2 = state.extension[depth+1];
+        Vextension2 = Vextension;
+        for (int vertex : vertices[w])
+        {
+            if (vertex > root && state.adjacent[vertex] == 0)
+                Vextension2.push_back(vertex);
+        }
+        
+        state.subgraph[depth] = w;
+        uint64_t mask2 = mask | (uint64_t)state.adjacent[w] << offset;
+        
+        for (int vertex : vertices[w])
+            state.adjacent[vertex] |= 1u << depth;
+        
+        extendPrefix<Visitor, EVERY_SIZE>(state, depth+1, root, k, mask2,
+                                          visitor);
+        
+        for (int vertex : vertices[w])
+            state.adjacent[vertex] &= ~(1u << depth);
+    }
+}
+
 #endif /* defined(__Homework_3__Graph__) */
\ No newline at end of file
@@ -0,0 +1,287 @@
+//------------------------------------------------------------------------------
+//  IncrementalCensus.cpp
+//------------------------------------------------------------------------------
+// IncrementalCensus keeps the size-k census of a Graph up to date while edges
+// are switched, added or removed, by recounting only the k-sets that contain
+// a changed vertex pair.
+//
+// ASSUMPTIONS:
+//   -- the Graph is only changed through apply, insertEdge and deleteEdge
+//      while an IncrementalCensus refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "IncrementalCensus.h"
+
+#include <algorithm>
+#include "Census.h"
+#include "EdgeSet.h"
+
+// An insert may grow the graph up to this many vertices, so a stray ID in an
+// update cannot allocate billions of empty adjacency sets
+const int MAX_GROWN_VERTICES = 1 << 24;
+
+//--------------------------------- isConnected --------------------------------
+// Whether a packed adjacency mask describes a connected graph
+// Preconditions: 1 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Returns true if all k vertices are reachable from vertex 0
+static bool isConnected(const uint64_t &mask, const int &k)
+{
+    int adj[MAX_SUBGRAPH_SIZE] = {0};
+    for (int j = 1; j < k; j++)
+        for (int i = 0; i < j; i++)
+            if (mask >> pairBit(i, j) & 1)
+            {
+                adj[i] |= 1 << j;
+                adj[j] |= 1 << i;
+            }
+
+    int reached = 1, frontier = 1;
+    while (frontier != 0)
+    {
+        int next = 0;
+        for (int i = 0; i < k; i++)
+            if (frontier >> i & 1)
+                next |= adj[i];
+        frontier = next & ~reached;
+        reached |= next;
+    }
+
+    return reached == (1 << k) - 1;
+}
+
+//--------------------------------- Constructor --------------------------------
+// Creates a census of the size-k subgraphs of graph that follows changes
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: No subgraph is counted yet
+IncrementalCensus::IncrementalCensus(Graph &graph, const int &k)
+    : graph(graph), k(k), classifier(k) {}
+
+//------------------------------------- run ------------------------------------
+// Counts the whole graph from scratch
+// Preconditions: threads >= 1
+// Postconditions: getCounts() holds the census of the graph
+void IncrementalCensus::run(const int &threads)
+{
+    CensusOptions options;
+    options.threads = threads;
+
+    Census full(graph, k);
+    full.run(options);
+    counts = full.getCounts();
+    total = full.getTotal();
+}
+
+//------------------------------------ apply -----------------------------------
+// Changes the graph and updates the census
+// Preconditions: removed and added list packed edges (see EdgeSet.h) in
+//                the order they were removed and added, as logged by
+//                Randomizer; an edge is only removed while present and
+//                only added while absent
+// Postconditions: The graph holds the net result of the changes and
+//                 getCounts() is its census
+void IncrementalCensus::apply(const vector<uint64_t> &removed,
+                              const vector<uint64_t> &added)
+{
+    // An edge is removed and added alternately, so its net change is the
+    // number of additions minus the number of removals: -1, 0 or +1
+    vector<uint64_t> gone(removed), came(added);
+    sort(gone.begin(), gone.end());
+    sort(came.begin(), came.end());
+
+    vector<uint64_t> pairs;
+    wasAdded.clear();
+    size_t g = 0, c = 0;
+    while (g < gone.size() || c < came.size())
+    {
+        uint64_t key = c == came.size() ||
+                       (g < gone.size() && gone[g] < came[c]) ? gone[g]
+                                                              : came[c];
+        int net = 0;
+        for (; g < gone.size() && gone[g] == key; g++)
+            net--;
+        for (; c < came.size() && came[c] == key; c++)
+            net++;
+
+        if (net != 0)
+        {
+            pairs.push_back(key);
+            wasAdded.push_back(net > 0);
+        }
+    }
+
+    update(pairs);
+}
+
+//---------------------------------- insertEdge --------------------------------
+// Adds the edge between vertex u and vertex v and updates the census
+// Preconditions: None
+// Postconditions: Returns false, changing nothing, if u == v, the edge
+//                 exists, a vertex is negative, or a vertex is new and not
+//                 below MAX_GROWN_VERTICES; otherwise the graph grows to
+//                 cover both vertices
+bool IncrementalCensus::insertEdge(const int &u, const int &v)
+{
+    const int top = max(u, v);
+    if (u < 0 || v < 0 || u == v ||
+        (top >= graph.size() && top >= MAX_GROWN_VERTICES) ||
+        !graph.addEdge(u, v))
+        return false;
+
+    wasAdded.assign(1, true);
+    update(vector<uint64_t>(1, edgeKey(u, v)));
+    return true;
+}
+
+//---------------------------------- deleteEdge --------------------------------
+// Removes the edge between vertex u and vertex v and updates the census
+// Preconditions: None
+// Postconditions: Returns false, changing nothing, if there is no such edge
+bool IncrementalCensus::deleteEdge(const int &u, const int &v)
+{
+    if (u < 0 || v < 0 || u >= graph.size() || v >= graph.size() ||
+        !graph.isEdge(u, v))
+        return false;
+
+    wasAdded.assign(1, false);
+    update(vector<uint64_t>(1, edgeKey(u, v)));
+    return true;
+}
+
+//------------------------------- PRIVATE: update ------------------------------
+// Changes the vertex pairs in pairs and updates the census
+// Preconditions: pairs are distinct packed edges; wasAdded[i] tells whether
+//                pairs[i] is absent and added, rather than present and removed
+// Postconditions: The graph and getCounts() reflect the changes
+void IncrementalCensus::update(const vector<uint64_t> &pairs)
+{
+    changed.clear();
+    for (size_t i = 0; i < pairs.size(); i++)
+        changed[pairs[i]] = (int)i;
+
+    // The graph becomes the union of the old and the new edges
+    for (size_t i = 0; i < pairs.size(); i++)
+        if (wasAdded[i])
+            graph.addEdge((int)(pairs[i] >> 32), (int)(pairs[i] & 0xffffffff));
+
+    if ((int)state.adjacent.size() != graph.size())
+        state.reset(k, graph.size());
+
+    delta.clear();
+    visited = 0;
+    for (current = 0; current < (int)pairs.size(); current++)
+    {
+        int seed[2] = {(int)(pairs[current] >> 32),
+                       (int)(pairs[current] & 0xffffffff)};
+        graph.enumerateSeeded(seed, 2, k, *this, state);
+    }
+
+    for (size_t i = 0; i < pairs.size(); i++)
+        if (!wasAdded[i])
+            graph.removeEdge((int)(pairs[i] >> 32),
+                             (int)(pairs[i] & 0xffffffff));
+
+    for (const auto &entry : delta)
+    {
+        if (entry.second == 0)
+            continue;
+
+        long long &count = counts[entry.first];
+        count += entry.second;
+        total += entry.second;
+        if (count == 0)
+            counts.erase(entry.first);
+    }
+}
+
+//--------------------------------- setListener --------------------------------
+// Reports the k-sets that change class in later updates
+// Preconditions: None
+// Postconditions: listener is called once per such k-set, from the calling
+//                 thread; an empty function removes it
+void IncrementalCensus::setListener(const ChangeCallback &listener)
+{
+    this->listener = listener;
+}
+
+//---------------------------------- getCounts ---------------------------------
+// Count of every class in the current graph
+// Preconditions: run was called
+// Postconditions: Returns canonical mask -> number of instances
+const ClassCounts &IncrementalCensus::getCounts() const
+{
+    return counts;
+}
+
+//---------------------------------- getTotal ----------------------------------
+// Number of subgraphs in the current graph
+// Preconditions: run was called
+// Postconditions: Returns the sum of getCounts() in constant time
+long long IncrementalCensus::getTotal() const
+{
+    return total;
+}
+
+//--------------------------------- getVisited ---------------------------------
+// Work done by the last apply
+// Preconditions: None
+// Postconditions: Returns the number of k-sets the last apply looked at
+long long IncrementalCensus::getVisited() const
+{
+    return visited;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes one "graph6 count" line per class
+// Preconditions: None
+// Postconditions: The census is written to out
+void IncrementalCensus::write(ostream &out) const
+{
+    for (const auto &entry : counts)
+        out << Classifier::toGraph6(entry.first, k) << "\t" << entry.second
+            << "\n";
+}
+
+//------------------------------------ visit -----------------------------------
+// Moves one k-set of the union graph from its old class to its new one
+// Preconditions: called by Graph::enumerateSeeded during apply; mask is
+//                the packed adjacency of subgraph in the union graph
+// Postconditions: The change in count of both classes is recorded
+void IncrementalCensus::visit(const int *subgraph, const int &k,
+                              const uint64_t &mask)
+{
+    visited++;
+
+    uint64_t before = mask, after = mask;
+    for (int j = 1; j < k; j++)
+        for (int i = 0; i < j; i++)
+        {
+            const uint64_t bit = (uint64_t)1 << pairBit(i, j);
+            if (!(mask & bit))
+                continue;
+
+            auto found = changed.find(edgeKey(subgraph[i], subgraph[j]));
+            if (found == changed.end())
+                continue;
+
+            // Handled already from an earlier changed pair
+            if (found->second < current)
+                return;
+
+            if (wasAdded[found->second])
+                before &= ~bit;
+            else
+                after &= ~bit;
+        }
+
+    // Disconnected sets have class 0, which no connected graph has for k >= 2
+    uint64_t from = 0, to = 0;
+    if (isConnected(before, k))
+        delta[from = classifier.classify(before)]--;
+    if (isConnected(after, k))
+        delta[to = classifier.classify(after)]++;
+
+    if (listener && from != to)
+        listener(subgraph, k, from, to);
+}
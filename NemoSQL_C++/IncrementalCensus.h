@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+//  IncrementalCensus.h
+//------------------------------------------------------------------------------
+// IncrementalCensus keeps the size-k census of a Graph up to date while edges
+// are switched, added or removed, without counting the whole graph again.
+//
+// Only subgraphs that contain both ends of a changed vertex pair can change
+// class. For a batch of changes, the edges to add are inserted first, so the
+// graph temporarily holds the union of the old and new edges; every changed
+// pair is then an edge of that union. The connected k-sets of the union that
+// contain a changed pair are enumerated from the pair as a seed (see
+// Graph::enumerateSeeded), and each is classified twice: without the added
+// edges (the old graph) and without the removed ones (the new graph). Where it
+// is connected it is taken out of the census under its old class and put back
+// under its new one. A set holding several changed pairs is only handled for
+// the first of them, in sorted order, so no set is counted twice.
+//
+// insertEdge and deleteEdge make the graph dynamic: each is a batch of one
+// change, so an update costs the enumeration of the k-sets around one edge.
+// The census and its total are kept current, so reading them costs at most
+// one step per class.
+//
+// A listener, when set, is told of every k-set whose class changes, which
+// lists the instances that appeared and disappeared (see DifferentialCensus).
+//
+// ASSUMPTIONS:
+//   -- the Graph is only changed through apply, insertEdge and deleteEdge
+//      while an IncrementalCensus refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__IncrementalCensus__
+#define __NemoSQL__IncrementalCensus__
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include "Checkpoint.h"
+#include "Classifier.h"
+#include "Enumeration.h"
+#include "Graph.h"
+#include "Parallel.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Called for a k-set whose class changes, with its vertices and its canonical
+// class before and after the change, 0 standing for disconnected
+typedef function<void(const int *subgraph, const int &k,
+                      const uint64_t &before, const uint64_t &after)>
+    ChangeCallback;
+
+class IncrementalCensus
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a census of the size-k subgraphs of graph that follows changes
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: No subgraph is counted yet
+    IncrementalCensus(Graph &graph, const int &k);
+
+
+    //----------------------------------- run ----------------------------------
+    // Counts the whole graph from scratch
+    // Preconditions: threads >= 1
+    // Postconditions: getCounts() holds the census of the graph
+    void run(const int &threads = defaultThreads());
+
+
+    //---------------------------------- apply ---------------------------------
+    // Changes the graph and updates the census
+    // Preconditions: removed and added list packed edges (see EdgeSet.h) in
+    //                the order they were removed and added, as logged by
+    //                Randomizer; an edge is only removed while present and
+    //                only added while absent
+    // Postconditions: The graph holds the net result of the changes and
+    //                 getCounts() is its census
+    void apply(const vector<uint64_t> &removed, const vector<uint64_t> &added);
+
+
+    //-------------------------------- insertEdge ------------------------------
+    // Adds the edge between vertex u and vertex v and updates the census
+    // Preconditions: None
+    // Postconditions: Returns false, changing nothing, if u == v, the edge
+    //                 exists, a vertex is negative, or a vertex is new and
+    //                 not below 2^24; otherwise the graph grows to cover both
+    //                 vertices
+    bool insertEdge(const int &u, const int &v);
+
+
+    //-------------------------------- deleteEdge ------------------------------
+    // Removes the edge between vertex u and vertex v and updates the census
+    // Preconditions: None
+    // Postconditions: Returns false, changing nothing, if there is no such edge
+    bool deleteEdge(const int &u, const int &v);
+
+
+    //------------------------------- setListener ------------------------------
+    // Reports the k-sets that change class in later updates
+    // Preconditions: None
+    // Postconditions: listener is called once per such k-set, from the
+    //                 calling thread; an empty function removes it
+    void setListener(const ChangeCallback &listener);
+
+
+    //-------------------------------- getCounts -------------------------------
+    // Count of every class in the current graph
+    // Preconditions: run was called
+    // Postconditions: Returns canonical mask -> number of instances
+    const ClassCounts &getCounts() const;
+
+
+    //-------------------------------- getTotal --------------------------------
+    // Number of subgraphs in the current graph
+    // Preconditions: run was called
+    // Postconditions: Returns the sum of getCounts() in constant time
+    long long getTotal() const;
+
+
+    //------------------------------- getVisited -------------------------------
+    // Work done by the last apply
+    // Preconditions: None
+    // Postconditions: Returns the number of k-sets the last apply looked at
+    long long getVisited() const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes one "graph6 count" line per class
+    // Preconditions: None
+    // Postconditions: The census is written to out
+    void write(ostream &out) const;
+
+
+    //-------------------------------- visit -----------------------------------
+    // Moves one k-set of the union graph from its old class to its new one
+    // Preconditions: called by Graph::enumerateSeeded during apply; mask is
+    //                the packed adjacency of subgraph in the union graph
+    // Postconditions: The change in count of both classes is recorded
+    void visit(const int *subgraph, const int &k, const uint64_t &mask);
+
+
+private:
+    Graph &graph;                           // graph being followed
+    int k;                                  // subgraph size
+    ClassCounts counts;                     // census of the current graph
+    long long total = 0;                    // sum of counts
+    Classifier classifier;                  // class cache
+    EnumerationState state;                 // enumeration buffers
+    unordered_map<uint64_t, int> changed;   // changed pair -> its position
+    vector<char> wasAdded;                  // by position: added, not removed
+    int current = 0;                        // position of the seed pair
+    unordered_map<uint64_t, long long> delta;   // class -> change in count
+    long long visited = 0;                  // k-sets looked at by apply
+    ChangeCallback listener;                // told of class changes, if set
+
+
+    //----------------------------- PRIVATE: update ----------------------------
+    // Changes the vertex pairs in pairs and updates the census
+    // Preconditions: pairs are distinct packed edges; wasAdded[i] tells
+    //                whether pairs[i] is absent and added, rather than
+    //                present and removed
+    // Postconditions: The graph and getCounts() reflect the changes
+    void update(const vector<uint64_t> &pairs);
+
+};
+
+#endif /* defined(__NemoSQL__IncrementalCensus__) */
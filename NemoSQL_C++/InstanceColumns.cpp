@@ -0,0 +1,503 @@
+//------------------------------------------------------------------------------
+//  InstanceColumns.cpp
+//------------------------------------------------------------------------------
+// InstanceColumns is a compact columnar file of the size-k subgraph instances
+// of a Graph, sorted by class, with bit-packed column chunks that a mapped
+// reader decodes one at a time.
+//
+// ASSUMPTIONS:
+//   -- writing holds every instance in memory while sorting
+//   -- vertex IDs fit in 32 bits
+//
+//------------------------------------------------------------------------------
+
+#include "InstanceColumns.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Classifier.h"
+
+static const char MAGIC[8] = {'N', 'E', 'M', 'O', 'C', 'O', 'L', 'S'};
+static const uint32_t VERSION = 1;
+static const size_t HEADER = sizeof(MAGIC) + 2 * sizeof(uint32_t) +
+                             3 * sizeof(uint64_t);
+
+//------------------------------------------------------------------------------
+// Visitor that keeps every instance as its class and ascending vertices
+class Collector
+{
+public:
+    Collector(const int &k) : classifier(k) {}
+
+    void visit(const int *subgraph, const int &k, const uint64_t &mask)
+    {
+        classes.push_back(classifier.classify(mask));
+
+        size_t at = vertices.size();
+        vertices.insert(vertices.end(), subgraph, subgraph + k);
+        sort(vertices.begin() + at, vertices.end());
+    }
+
+    Classifier classifier;                  // class cache
+    vector<uint64_t> classes;               // class of each instance
+    vector<uint32_t> vertices;              // k vertices per instance
+};
+
+//----------------------------------- bitsFor ----------------------------------
+// Bits needed to store a value
+// Preconditions: None
+// Postconditions: Returns 0 for 0, otherwise the position of the top bit + 1
+static uint32_t bitsFor(const uint32_t &value)
+{
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+}
+
+//--------------------------------- Constructor --------------------------------
+// Creates a reader with no file open
+// Preconditions: None
+// Postconditions: open must be called before reading
+InstanceColumns::InstanceColumns() : data(nullptr), length(0), k(0), rows(0) {}
+
+//--------------------------------- Destructor ---------------------------------
+// Unmaps the file
+// Preconditions: None
+// Postconditions: None
+InstanceColumns::~InstanceColumns()
+{
+    close();
+}
+
+//------------------------------------ write -----------------------------------
+// Writes the connected size-k subgraphs of graph to path
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE; groupRows >= 1
+// Postconditions: Returns the number of rows written, or -1 if the file could
+//                 not be written
+long long InstanceColumns::write(const Graph &graph, const int &k,
+                                 const string &path, const int &groupRows)
+{
+    Collector instances(k);
+    graph.enumerateSubgraph(k, instances);
+
+    const size_t count = instances.classes.size();
+    vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++)
+        order[i] = i;
+
+    const uint32_t *vertices = instances.vertices.data();
+    sort(order.begin(), order.end(), [&](const size_t &a, const size_t &b)
+    {
+        if (instances.classes[a] != instances.classes[b])
+            return instances.classes[a] < instances.classes[b];
+        return lexicographical_compare(vertices + a * k, vertices + a * k + k,
+                                       vertices + b * k, vertices + b * k + k);
+    });
+
+    string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+        return -1;
+
+    // The header is written again once the footer offset is known
+    vector<char> header(HEADER, 0);
+    bool ok = fwrite(header.data(), 1, HEADER, file) == HEADER;
+    uint64_t offset = HEADER;
+
+    vector<char> footer;
+    auto put = [&](const void *value, const size_t &size)
+    {
+        footer.insert(footer.end(), (const char *)value,
+                      (const char *)value + size);
+    };
+
+    uint64_t groups = 0;
+    vector<uint32_t> values;
+    vector<uint64_t> words;
+    for (size_t first = 0; ok && first < count; groups++)
+    {
+        // A group ends at groupRows rows or at the end of its class
+        const uint64_t type = instances.classes[order[first]];
+        size_t last = first + 1;
+        while (last < count && last - first < (size_t)groupRows &&
+               instances.classes[order[last]] == type)
+            last++;
+
+        const uint64_t size = last - first;
+        put(&type, sizeof(type));
+        put(&size, sizeof(size));
+
+        for (int column = 0; ok && column < k; column++)
+        {
+            values.resize(size);
+            for (size_t row = 0; row < size; row++)
+                values[row] = vertices[order[first + row] * k + column];
+
+            uint32_t minimum = *min_element(values.begin(), values.end());
+            uint32_t maximum = *max_element(values.begin(), values.end());
+
+            // The first column ascends within the group
+            uint32_t delta = column == 0, widest = 0;
+            for (size_t row = size; row-- > 0;)
+            {
+                values[row] -= delta && row > 0 ? values[row - 1] : minimum;
+                widest = max(widest, values[row]);
+            }
+            uint32_t width = bitsFor(widest);
+
+            words.assign((size * width + 63) / 64, 0);
+            for (size_t row = 0; row < size && width > 0; row++)
+            {
+                size_t bit = row * width;
+                words[bit / 64] |= (uint64_t)values[row] << (bit % 64);
+                if (bit % 64 + width > 64)
+                    words[bit / 64 + 1] |= (uint64_t)values[row] >>
+                                           (64 - bit % 64);
+            }
+
+            put(&offset, sizeof(offset));
+            put(&minimum, sizeof(minimum));
+            put(&maximum, sizeof(maximum));
+            put(&width, sizeof(width));
+            put(&delta, sizeof(delta));
+
+            ok = fwrite(words.data(), sizeof(uint64_t), words.size(), file) ==
+                 words.size();
+            offset += words.size() * sizeof(uint64_t);
+        }
+
+        first = last;
+    }
+
+    const uint64_t rowCount = count;
+    const int32_t size = k;
+    memcpy(&header[0], MAGIC, sizeof(MAGIC));
+    memcpy(&header[8], &VERSION, sizeof(VERSION));
+    memcpy(&header[12], &size, sizeof(size));
+    memcpy(&header[16], &rowCount, sizeof(rowCount));
+    memcpy(&header[24], &groups, sizeof(groups));
+    memcpy(&header[32], &offset, sizeof(offset));
+
+    ok = ok &&
+         fwrite(footer.data(), 1, footer.size(), file) == footer.size() &&
+         fseek(file, 0, SEEK_SET) == 0 &&
+         fwrite(header.data(), 1, HEADER, file) == HEADER &&
+         fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return -1;
+    }
+
+    return (long long)count;
+}
+
+//------------------------------------- open -----------------------------------
+// Maps the file at path
+// Preconditions: None
+// Postconditions: Returns false, with nothing open, if path is not a valid
+//                 instance file
+bool InstanceColumns::open(const string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= HEADER)
+        mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data = (const unsigned char *)mapped;
+    length = info.st_size;
+
+    uint32_t version;
+    int32_t size;
+    uint64_t rowCount, groups, footer;
+    memcpy(&version, data + 8, sizeof(version));
+    memcpy(&size, data + 12, sizeof(size));
+    memcpy(&rowCount, data + 16, sizeof(rowCount));
+    memcpy(&groups, data + 24, sizeof(groups));
+    memcpy(&footer, data + 32, sizeof(footer));
+
+    const size_t perGroup = 2 * sizeof(uint64_t) + size * sizeof(Chunk);
+    if (memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION ||
+        size < 2 || size > MAX_SUBGRAPH_SIZE || footer > length ||
+        groups > (length - footer) / perGroup)
+    {
+        close();
+        return false;
+    }
+
+    k = size;
+    rows = (long long)rowCount;
+    classes.resize(groups);
+    groupRows.resize(groups);
+    groupFirst.assign(groups + 1, 0);
+    chunks.resize(groups * k);
+
+    const unsigned char *at = data + footer;
+    for (uint64_t group = 0; group < groups; group++)
+    {
+        uint64_t groupSize;
+        memcpy(&classes[group], at, sizeof(uint64_t));
+        memcpy(&groupSize, at + sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&chunks[group * k], at + 2 * sizeof(uint64_t),
+               k * sizeof(Chunk));
+        groupRows[group] = (int)groupSize;
+        groupFirst[group + 1] = groupFirst[group] + (long long)groupSize;
+        at += perGroup;
+
+        for (int column = 0; column < k; column++)
+        {
+            const Chunk &chunk = chunks[group * k + column];
+            if (chunk.width > 32 ||
+                chunk.offset + (groupSize * chunk.width + 63) / 64 * 8 > footer)
+            {
+                close();
+                return false;
+            }
+        }
+    }
+
+    if (groupFirst[groups] != rows)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------ close -----------------------------------
+// Unmaps the file
+// Preconditions: None
+// Postconditions: Nothing is open
+void InstanceColumns::close()
+{
+    if (data != nullptr)
+        munmap((void *)data, length);
+
+    data = nullptr;
+    length = 0;
+    k = 0;
+    rows = 0;
+    classes.clear();
+    groupRows.clear();
+    groupFirst.clear();
+    chunks.clear();
+}
+
+//----------------------------------- getSize ----------------------------------
+// Subgraph size of the file
+// Preconditions: open succeeded
+// Postconditions: Returns k
+int InstanceColumns::getSize() const
+{
+    return k;
+}
+
+//----------------------------------- getRows ----------------------------------
+// Number of instances in the file
+// Preconditions: open succeeded
+// Postconditions: Returns the number of rows
+long long InstanceColumns::getRows() const
+{
+    return rows;
+}
+
+//---------------------------------- getGroups ---------------------------------
+// Number of row groups in the file
+// Preconditions: open succeeded
+// Postconditions: Returns the number of groups
+int InstanceColumns::getGroups() const
+{
+    return (int)classes.size();
+}
+
+//-------------------------------- getGroupClass -------------------------------
+// Class of the rows of a group
+// Preconditions: 0 <= group < getGroups()
+// Postconditions: Returns the canonical mask shared by the group's rows
+uint64_t InstanceColumns::getGroupClass(const int &group) const
+{
+    return classes[group];
+}
+
+//-------------------------------- getGroupRows --------------------------------
+// Number of rows in a group
+// Preconditions: 0 <= group < getGroups()
+// Postconditions: Returns the group's row count
+int InstanceColumns::getGroupRows(const int &group) const
+{
+    return groupRows[group];
+}
+
+//-------------------------------- getGroupFirst -------------------------------
+// Number of the first row of a group
+// Preconditions: 0 <= group <= getGroups()
+// Postconditions: Returns the rows in the groups before group
+long long InstanceColumns::getGroupFirst(const int &group) const
+{
+    return groupFirst[group];
+}
+
+//--------------------------------- classGroups --------------------------------
+// Groups holding one class
+// Preconditions: open succeeded
+// Postconditions: Returns [first, last) such that exactly the groups in it
+//                 hold rows of class type (empty if there are none)
+pair<int, int> InstanceColumns::classGroups(const uint64_t &type) const
+{
+    auto range = equal_range(classes.begin(), classes.end(), type);
+    return make_pair((int)(range.first - classes.begin()),
+                     (int)(range.second - classes.begin()));
+}
+
+//---------------------------------- readColumn --------------------------------
+// Decodes one column of a group
+// Preconditions: 0 <= group < getGroups(); 0 <= column < getSize(); out has
+//                room for getGroupRows(group) values
+// Postconditions: out holds vertex position column of every row
+void InstanceColumns::readColumn(const int &group, const int &column,
+                                 uint32_t *out) const
+{
+    const Chunk &chunk = chunks[(size_t)group * k + column];
+    const uint64_t *words = (const uint64_t *)(data + chunk.offset);
+    const int size = groupRows[group];
+    const uint32_t width = chunk.width;
+    const uint64_t mask = ((uint64_t)1 << width) - 1;
+
+    for (int row = 0; row < size; row++)
+    {
+        uint64_t value = 0;
+        if (width > 0)
+        {
+            size_t bit = (size_t)row * width;
+            value = words[bit / 64] >> (bit % 64);
+            if (bit % 64 + width > 64)
+                value |= words[bit / 64 + 1] << (64 - bit % 64);
+        }
+        out[row] = (uint32_t)(value & mask);
+    }
+
+    if (chunk.delta)
+    {
+        uint32_t running = chunk.minimum;
+        for (int row = 0; row < size; row++)
+            out[row] = running += out[row];
+    }
+    else
+        for (int row = 0; row < size; row++)
+            out[row] += chunk.minimum;
+}
+
+//------------------------------------- find -----------------------------------
+// Instances of a class that contain a vertex
+// Preconditions: open succeeded
+// Postconditions: found holds the matching rows of getSize() ascending vertex
+//                 IDs, one after the other, in file order; type 0 matches
+//                 every class. Returns the number of chunks decoded
+long long InstanceColumns::find(const uint64_t &type, const uint32_t &vertex,
+                                vector<uint32_t> &found) const
+{
+    found.clear();
+
+    pair<int, int> range = type == 0 ? make_pair(0, getGroups())
+                                     : classGroups(type);
+
+    long long decoded = 0;
+    vector<vector<uint32_t>> columns(k);
+    vector<char> match;
+    for (int group = range.first; group < range.second; group++)
+    {
+        const int size = groupRows[group];
+        const Chunk *chunk = &chunks[(size_t)group * k];
+        match.assign(size, 0);
+
+        // Only chunks whose range holds the vertex can contain it
+        bool any = false;
+        vector<char> ready(k, 0);
+        for (int column = 0; column < k; column++)
+        {
+            if (vertex < chunk[column].minimum ||
+                vertex > chunk[column].maximum)
+                continue;
+
+            columns[column].resize(size);
+            readColumn(group, column, columns[column].data());
+            ready[column] = 1;
+            decoded++;
+
+            for (int row = 0; row < size; row++)
+                if (columns[column][row] == vertex)
+                {
+                    match[row] = 1;
+                    any = true;
+                }
+        }
+
+        if (!any)
+            continue;
+
+        for (int column = 0; column < k; column++)
+            if (!ready[column])
+            {
+                columns[column].resize(size);
+                readColumn(group, column, columns[column].data());
+                decoded++;
+            }
+
+        for (int row = 0; row < size; row++)
+            if (match[row])
+                for (int column = 0; column < k; column++)
+                    found.push_back(columns[column][row]);
+    }
+
+    return decoded;
+}
+
+//---------------------------------- readRows ----------------------------------
+// Rows with given numbers
+// Preconditions: open succeeded; numbers ascend, each below getRows()
+// Postconditions: found holds the getSize() ascending vertex IDs of each row,
+//                 one row after the other; every group holding one of the
+//                 rows is decoded once
+void InstanceColumns::readRows(const vector<uint64_t> &numbers,
+                               vector<uint32_t> &found) const
+{
+    found.clear();
+    found.reserve(numbers.size() * k);
+
+    vector<vector<uint32_t>> columns(k);
+    for (size_t i = 0; i < numbers.size();)
+    {
+        const int group = (int)(upper_bound(groupFirst.begin(),
+                                            groupFirst.end(),
+                                            (long long)numbers[i]) -
+                                groupFirst.begin()) - 1;
+        for (int column = 0; column < k; column++)
+        {
+            columns[column].resize(groupRows[group]);
+            readColumn(group, column, columns[column].data());
+        }
+
+        for (; i < numbers.size() &&
+               (long long)numbers[i] < groupFirst[group + 1]; i++)
+        {
+            const size_t row = numbers[i] - groupFirst[group];
+            for (int column = 0; column < k; column++)
+                found.push_back(columns[column][row]);
+        }
+    }
+}
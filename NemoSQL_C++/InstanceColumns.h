@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+//  InstanceColumns.h
+//------------------------------------------------------------------------------
+// InstanceColumns is a compact columnar file of the connected size-k subgraph
+// instances of a Graph, and the reader for it.
+//
+// Instances are sorted by class, then by their ascending vertex IDs, and cut
+// into row groups of at most groupRows rows that never span two classes. In a
+// group, vertex position i of every row is one column chunk: its values minus
+// the chunk minimum, bit-packed at the width of the largest one. The first
+// column is sorted within a group, so it stores the differences between
+// consecutive values instead, which take only a few bits. A row costs a few
+// bytes instead of the dozens an SQLite row takes.
+//
+// The footer keeps, per group, its class and row count and, per chunk, its
+// offset, bit width and minimum and maximum vertex. The reader maps the file
+// and decodes single chunks on demand: a class is a contiguous range of groups
+// found by binary search, and a chunk whose [minimum, maximum] does not hold a
+// vertex is never decoded when looking for that vertex.
+//
+// File layout (little endian, as written by the host; chunks and footer start
+// on 8-byte boundaries):
+//   char[8]   "NEMOCOLS"
+//   uint32    version
+//   int32     k
+//   uint64    number of rows
+//   uint64    number of groups
+//   uint64    offset of the footer
+//   chunks    uint64 words of packed values
+//   footer    per group: uint64 class, uint64 rows, then k chunks of
+//             (uint64 offset, uint32 minimum, uint32 maximum, uint32 width,
+//             uint32 delta-coded)
+//
+// ASSUMPTIONS:
+//   -- writing holds every instance in memory while sorting
+//   -- vertex IDs fit in 32 bits
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__InstanceColumns__
+#define __NemoSQL__InstanceColumns__
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+class InstanceColumns
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a reader with no file open
+    // Preconditions: None
+    // Postconditions: open must be called before reading
+    InstanceColumns();
+
+
+    //------------------------------- Destructor -------------------------------
+    // Unmaps the file
+    // Preconditions: None
+    // Postconditions: None
+    ~InstanceColumns();
+
+
+    //----------------------------------- write --------------------------------
+    // Writes the connected size-k subgraphs of graph to path
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE; groupRows >= 1
+    // Postconditions: Returns the number of rows written, or -1 if the file
+    //                 could not be written
+    static long long write(const Graph &graph, const int &k,
+                           const string &path, const int &groupRows = 65536);
+
+
+    //----------------------------------- open ---------------------------------
+    // Maps the file at path
+    // Preconditions: None
+    // Postconditions: Returns false, with nothing open, if path is not a
+    //                 valid instance file
+    bool open(const string &path);
+
+
+    //---------------------------------- close ---------------------------------
+    // Unmaps the file
+    // Preconditions: None
+    // Postconditions: Nothing is open
+    void close();
+
+
+    //--------------------------------- getSize --------------------------------
+    // Subgraph size of the file
+    // Preconditions: open succeeded
+    // Postconditions: Returns k
+    int getSize() const;
+
+
+    //--------------------------------- getRows --------------------------------
+    // Number of instances in the file
+    // Preconditions: open succeeded
+    // Postconditions: Returns the number of rows
+    long long getRows() const;
+
+
+    //-------------------------------- getGroups -------------------------------
+    // Number of row groups in the file
+    // Preconditions: open succeeded
+    // Postconditions: Returns the number of groups
+    int getGroups() const;
+
+
+    //------------------------------ getGroupClass -----------------------------
+    // Class of the rows of a group
+    // Preconditions: 0 <= group < getGroups()
+    // Postconditions: Returns the canonical mask shared by the group's rows
+    uint64_t getGroupClass(const int &group) const;
+
+
+    //------------------------------ getGroupRows ------------------------------
+    // Number of rows in a group
+    // Preconditions: 0 <= group < getGroups()
+    // Postconditions: Returns the group's row count
+    int getGroupRows(const int &group) const;
+
+
+    //------------------------------ getGroupFirst -----------------------------
+    // Number of the first row of a group
+    // Preconditions: 0 <= group <= getGroups()
+    // Postconditions: Returns the rows in the groups before group
+    long long getGroupFirst(const int &group) const;
+
+
+    //------------------------------- classGroups ------------------------------
+    // Groups holding one class
+    // Preconditions: open succeeded
+    // Postconditions: Returns [first, last) such that exactly the groups in
+    //                 it hold rows of class type (empty if there are none)
+    pair<int, int> classGroups(const uint64_t &type) const;
+
+
+    //-------------------------------- readColumn ------------------------------
+    // Decodes one column of a group
+    // Preconditions: 0 <= group < getGroups(); 0 <= column < getSize(); out
+    //                has room for getGroupRows(group) values
+    // Postconditions: out holds vertex position column of every row
+    void readColumn(const int &group, const int &column, uint32_t *out) const;
+
+
+    //----------------------------------- find ---------------------------------
+    // Instances of a class that contain a vertex
+    // Preconditions: open succeeded
+    // Postconditions: found holds the matching rows of getSize() ascending
+    //                 vertex IDs, one after the other, in file order; type 0
+    //                 matches every class. Returns the number of chunks
+    //                 decoded
+    long long find(const uint64_t &type, const uint32_t &vertex,
+                   vector<uint32_t> &found) const;
+
+
+    //--------------------------------- readRows -------------------------------
+    // Rows with given numbers
+    // Preconditions: open succeeded; numbers ascend, each below getRows()
+    // Postconditions: found holds the getSize() ascending vertex IDs of each
+    //                 row, one row after the other; every group holding one
+    //                 of the rows is decoded once
+    void readRows(const vector<uint64_t> &numbers,
+                  vector<uint32_t> &found) const;
+
+
+private:
+    // Location and statistics of one column chunk
+    struct Chunk
+    {
+        uint64_t offset;                    // of the packed words
+        uint32_t minimum;                   // smallest vertex in the chunk
+        uint32_t maximum;                   // largest vertex in the chunk
+        uint32_t width;                     // bits per packed value
+        uint32_t delta;                     // values are differences
+    };
+
+    const unsigned char *data;              // mapped file, or nullptr
+    size_t length;                          // bytes mapped
+    int k;                                  // subgraph size
+    long long rows;                         // instances in the file
+    vector<uint64_t> classes;               // class of each group
+    vector<int> groupRows;                  // rows of each group
+    vector<long long> groupFirst;           // first row of each group, rows
+    vector<Chunk> chunks;                   // k chunks per group
+
+};
+
+#endif /* defined(__NemoSQL__InstanceColumns__) */
@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------------
+//  InstanceIndex.cpp
+//------------------------------------------------------------------------------
+// InstanceIndex is an inverted index of a columnar instance file: for every
+// vertex, the block-compressed numbers of the rows that contain it.
+//
+// ASSUMPTIONS:
+//   -- the instance file is not rewritten while its index is in use
+//
+//------------------------------------------------------------------------------
+
+#include "InstanceIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[8] = {'N', 'E', 'M', 'O', 'I', 'N', 'D', 'X'};
+static const uint32_t VERSION = 1;
+static const size_t HEADER = 48;
+static const uint64_t BLOCK = 128;          // postings per block
+
+//------------------------------------------------------------------------------
+// Posting list of one vertex while the index is built
+class PostingList
+{
+public:
+    //------------------------------------ add ---------------------------------
+    // Appends a row number
+    // Preconditions: number is above every number added before
+    // Postconditions: A new block is started every BLOCK numbers
+    void add(const uint64_t &number)
+    {
+        if (count % BLOCK == 0)
+        {
+            firsts.push_back(number);
+            offsets.push_back(bytes.size());
+        }
+        else
+        {
+            uint64_t difference = number - last;
+            while (difference >= 0x80)
+            {
+                bytes.push_back((unsigned char)(difference | 0x80));
+                difference >>= 7;
+            }
+            bytes.push_back((unsigned char)difference);
+        }
+
+        last = number;
+        count++;
+    }
+
+    vector<unsigned char> bytes;            // varint differences
+    vector<uint64_t> firsts;                // first number of each block
+    vector<uint64_t> offsets;               // of each block in bytes
+    uint64_t last = 0;                      // number added last
+    uint64_t count = 0;                     // numbers added
+};
+
+//--------------------------------- Constructor --------------------------------
+// Creates an index with no file open
+// Preconditions: None
+// Postconditions: open must be called before lookups
+InstanceIndex::InstanceIndex() : data(nullptr), length(0)
+{
+    close();
+}
+
+//--------------------------------- Destructor ---------------------------------
+// Unmaps the file
+// Preconditions: None
+// Postconditions: None
+InstanceIndex::~InstanceIndex()
+{
+    close();
+}
+
+//------------------------------------ build -----------------------------------
+// Writes the index of an instance file to path
+// Preconditions: table is open
+// Postconditions: Returns the number of postings written, or -1 if the file
+//                 could not be written
+long long InstanceIndex::build(const InstanceColumns &table,
+                               const string &path)
+{
+    const int k = table.getSize();
+    vector<ClassRange> ranges;
+    vector<PostingList> lists;
+
+    // Rows are read in order, so every list grows in ascending order
+    vector<vector<uint32_t>> columns(k);
+    for (int group = 0; group < table.getGroups(); group++)
+    {
+        const uint64_t type = table.getGroupClass(group);
+        const uint64_t first = table.getGroupFirst(group);
+        const uint64_t end = table.getGroupFirst(group + 1);
+        if (ranges.empty() || ranges.back().type != type)
+            ranges.push_back({type, first, end});
+        else
+            ranges.back().end = end;
+
+        for (int column = 0; column < k; column++)
+        {
+            columns[column].resize(table.getGroupRows(group));
+            table.readColumn(group, column, columns[column].data());
+        }
+
+        for (uint64_t row = 0; row < end - first; row++)
+            for (int column = 0; column < k; column++)
+            {
+                const uint32_t vertex = columns[column][row];
+                if (vertex >= lists.size())
+                    lists.resize((size_t)vertex + 1);
+                lists[vertex].add(first + row);
+            }
+    }
+
+    const uint32_t vertices = (uint32_t)lists.size();
+    vector<uint64_t> postings(1, 0), blocks(1, 0);
+    uint64_t byteCount = 0;
+    for (const PostingList &list : lists)
+    {
+        postings.push_back(postings.back() + list.count);
+        blocks.push_back(blocks.back() + list.firsts.size());
+        byteCount += list.bytes.size();
+    }
+
+    string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+        return -1;
+
+    unsigned char header[HEADER] = {};
+    const int32_t size = k;
+    const uint64_t rowCount = table.getRows();
+    const uint32_t classCount = (uint32_t)ranges.size();
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    memcpy(header + 8, &VERSION, sizeof(VERSION));
+    memcpy(header + 12, &size, sizeof(size));
+    memcpy(header + 16, &rowCount, sizeof(rowCount));
+    memcpy(header + 24, &vertices, sizeof(vertices));
+    memcpy(header + 28, &classCount, sizeof(classCount));
+    memcpy(header + 32, &blocks.back(), sizeof(uint64_t));
+    memcpy(header + 40, &byteCount, sizeof(byteCount));
+
+    bool ok = fwrite(header, 1, HEADER, file) == HEADER &&
+              fwrite(ranges.data(), sizeof(ClassRange), ranges.size(), file) ==
+              ranges.size() &&
+              fwrite(postings.data(), sizeof(uint64_t), postings.size(),
+                     file) == postings.size() &&
+              fwrite(blocks.data(), sizeof(uint64_t), blocks.size(), file) ==
+              blocks.size();
+
+    // Block offsets become offsets into the bytes of every list together
+    uint64_t base = 0;
+    for (size_t v = 0; ok && v < lists.size(); v++)
+    {
+        for (size_t b = 0; ok && b < lists[v].firsts.size(); b++)
+        {
+            Skip skip = {lists[v].firsts[b], base + lists[v].offsets[b]};
+            ok = fwrite(&skip, sizeof(skip), 1, file) == 1;
+        }
+        base += lists[v].bytes.size();
+    }
+
+    for (size_t v = 0; ok && v < lists.size(); v++)
+        ok = fwrite(lists[v].bytes.data(), 1, lists[v].bytes.size(), file) ==
+             lists[v].bytes.size();
+
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return -1;
+    }
+
+    return (long long)postings.back();
+}
+
+//------------------------------------- open -----------------------------------
+// Maps the index at path
+// Preconditions: None
+// Postconditions: Returns false, with nothing open, if path is not a valid
+//                 index
+bool InstanceIndex::open(const string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= HEADER)
+        mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data = (const unsigned char *)mapped;
+    length = info.st_size;
+
+    uint32_t version;
+    int32_t size;
+    uint64_t rowCount, blockCount, byteCount;
+    memcpy(&version, data + 8, sizeof(version));
+    memcpy(&size, data + 12, sizeof(size));
+    memcpy(&rowCount, data + 16, sizeof(rowCount));
+    memcpy(&vertices, data + 24, sizeof(vertices));
+    memcpy(&classCount, data + 28, sizeof(classCount));
+    memcpy(&blockCount, data + 32, sizeof(blockCount));
+    memcpy(&byteCount, data + 40, sizeof(byteCount));
+
+    const uint64_t expected = HEADER + classCount * sizeof(ClassRange) +
+                              2 * ((uint64_t)vertices + 1) * sizeof(uint64_t) +
+                              blockCount * sizeof(Skip) + byteCount;
+    if (memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION ||
+        size < 2 || size > MAX_SUBGRAPH_SIZE || blockCount > length ||
+        byteCount > length || expected != length)
+    {
+        close();
+        return false;
+    }
+
+    k = size;
+    rows = (long long)rowCount;
+    classes = (const ClassRange *)(data + HEADER);
+    postings = (const uint64_t *)(classes + classCount);
+    blocks = postings + vertices + 1;
+    skips = (const Skip *)(blocks + vertices + 1);
+    bytes = (const unsigned char *)(skips + blockCount);
+
+    if (blocks[vertices] != blockCount)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------ close -----------------------------------
+// Unmaps the file
+// Preconditions: None
+// Postconditions: Nothing is open
+void InstanceIndex::close()
+{
+    if (data != nullptr)
+        munmap((void *)data, length);
+
+    data = nullptr;
+    length = 0;
+    k = 0;
+    rows = 0;
+    vertices = 0;
+    classCount = 0;
+    classes = nullptr;
+    postings = nullptr;
+    blocks = nullptr;
+    skips = nullptr;
+    bytes = nullptr;
+}
+
+//----------------------------------- getSize ----------------------------------
+// Subgraph size of the indexed file
+// Preconditions: open succeeded
+// Postconditions: Returns k
+int InstanceIndex::getSize() const
+{
+    return k;
+}
+
+//----------------------------------- getRows ----------------------------------
+// Number of rows of the indexed file
+// Preconditions: open succeeded
+// Postconditions: Returns the number of rows
+long long InstanceIndex::getRows() const
+{
+    return rows;
+}
+
+//---------------------------------- getCount ----------------------------------
+// Number of instances that contain a vertex
+// Preconditions: open succeeded
+// Postconditions: Returns the length of the posting list of vertex
+long long InstanceIndex::getCount(const uint32_t &vertex) const
+{
+    if (vertex >= vertices)
+        return 0;
+
+    return (long long)(postings[vertex + 1] - postings[vertex]);
+}
+
+//------------------------------------- find -----------------------------------
+// Instances of a class that contain a vertex
+// Preconditions: open succeeded
+// Postconditions: numbers holds, ascending, the rows of class type that
+//                 contain vertex; type 0 matches every class. Returns the
+//                 number of blocks decoded
+long long InstanceIndex::find(const uint64_t &type, const uint32_t &vertex,
+                              vector<uint64_t> &numbers) const
+{
+    numbers.clear();
+    if (vertex >= vertices)
+        return 0;
+
+    uint64_t first = 0, end = (uint64_t)rows;
+    if (type != 0)
+    {
+        const ClassRange *range = lower_bound(classes, classes + classCount,
+                                              type,
+                                              [](const ClassRange &a,
+                                                 const uint64_t &b)
+                                              {
+                                                  return a.type < b;
+                                              });
+        if (range == classes + classCount || range->type != type)
+            return 0;
+        first = range->first;
+        end = range->end;
+    }
+
+    // Start at the last block beginning at or before the first row wanted
+    const Skip *begin = skips + blocks[vertex];
+    const Skip *stop = skips + blocks[vertex + 1];
+    const Skip *block = upper_bound(begin, stop, first,
+                                    [](const uint64_t &a, const Skip &b)
+                                    {
+                                        return a < b.first;
+                                    });
+    if (block != begin)
+        block--;
+
+    const uint64_t count = postings[vertex + 1] - postings[vertex];
+    long long decoded = 0;
+    for (; block < stop && block->first < end; block++)
+    {
+        const uint64_t index = (block - begin) * BLOCK;
+        const uint64_t size = min(BLOCK, count - index);
+        const unsigned char *at = bytes + block->offset;
+        uint64_t number = block->first;
+        decoded++;
+
+        for (uint64_t i = 0; i < size && number < end; i++)
+        {
+            if (i > 0)
+            {
+                uint64_t difference = 0;
+                for (int shift = 0; ; shift += 7)
+                {
+                    difference |= (uint64_t)(*at & 0x7f) << shift;
+                    if (!(*at++ & 0x80))
+                        break;
+                }
+                number += difference;
+            }
+
+            if (number >= first && number < end)
+                numbers.push_back(number);
+        }
+    }
+
+    return decoded;
+}
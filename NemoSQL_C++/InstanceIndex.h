@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+//  InstanceIndex.h
+//------------------------------------------------------------------------------
+// InstanceIndex is an inverted index of a columnar instance file (see
+// InstanceColumns.h): for every vertex, the ascending numbers of the rows
+// (instances) that contain it, so the instances of one protein are found
+// without scanning the others.
+//
+// A vertex's posting list is cut into blocks of 128 numbers. A block is its
+// first number, kept in a skip table with the block's byte offset, followed by
+// the differences between consecutive numbers as LEB128 varints, usually one
+// or two bytes each. The instance file holds each class as a contiguous range
+// of rows, so a class filter is a row range: the skip table is binary searched
+// for the block holding the first row of the class, and decoding stops at the
+// first number past it. A lookup touches the directory entry of the vertex,
+// a few skip entries and the blocks it returns.
+//
+// The index is written next to the instance file, as <file>.idx. File layout
+// (little endian, as written by the host; every section starts on an 8-byte
+// boundary):
+//   char[8]   "NEMOINDX"
+//   uint32    version
+//   int32     k
+//   uint64    number of rows of the instance file
+//   uint32    number of vertex slots
+//   uint32    number of classes
+//   uint64    number of blocks
+//   uint64    number of posting bytes
+//   classes   per class: uint64 class, uint64 first row, uint64 end row
+//   postings  (vertices + 1) uint64 running totals of postings per vertex
+//   blocks    (vertices + 1) uint64 running totals of blocks per vertex
+//   skips     per block: uint64 first row, uint64 byte offset
+//   bytes     the varint differences
+//
+// ASSUMPTIONS:
+//   -- the instance file is not rewritten while its index is in use
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__InstanceIndex__
+#define __NemoSQL__InstanceIndex__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "InstanceColumns.h"
+
+using namespace std;
+
+class InstanceIndex
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates an index with no file open
+    // Preconditions: None
+    // Postconditions: open must be called before lookups
+    InstanceIndex();
+
+
+    //------------------------------- Destructor -------------------------------
+    // Unmaps the file
+    // Preconditions: None
+    // Postconditions: None
+    ~InstanceIndex();
+
+
+    //----------------------------------- build --------------------------------
+    // Writes the index of an instance file to path
+    // Preconditions: table is open
+    // Postconditions: Returns the number of postings written, or -1 if the
+    //                 file could not be written
+    static long long build(const InstanceColumns &table, const string &path);
+
+
+    //----------------------------------- open ---------------------------------
+    // Maps the index at path
+    // Preconditions: None
+    // Postconditions: Returns false, with nothing open, if path is not a
+    //                 valid index
+    bool open(const string &path);
+
+
+    //---------------------------------- close ---------------------------------
+    // Unmaps the file
+    // Preconditions: None
+    // Postconditions: Nothing is open
+    void close();
+
+
+    //--------------------------------- getSize --------------------------------
+    // Subgraph size of the indexed file
+    // Preconditions: open succeeded
+    // Postconditions: Returns k
+    int getSize() const;
+
+
+    //--------------------------------- getRows --------------------------------
+    // Number of rows of the indexed file
+    // Preconditions: open succeeded
+    // Postconditions: Returns the number of rows
+    long long getRows() const;
+
+
+    //-------------------------------- getCount --------------------------------
+    // Number of instances that contain a vertex
+    // Preconditions: open succeeded
+    // Postconditions: Returns the length of the posting list of vertex
+    long long getCount(const uint32_t &vertex) const;
+
+
+    //----------------------------------- find ---------------------------------
+    // Instances of a class that contain a vertex
+    // Preconditions: open succeeded
+    // Postconditions: numbers holds, ascending, the rows of class type that
+    //                 contain vertex; type 0 matches every class. Returns
+    //                 the number of blocks decoded
+    long long find(const uint64_t &type, const uint32_t &vertex,
+                   vector<uint64_t> &numbers) const;
+
+
+private:
+    // Rows of one class
+    struct ClassRange
+    {
+        uint64_t type;                      // canonical mask
+        uint64_t first;                     // first row
+        uint64_t end;                       // row after the last
+    };
+
+    // Start of one block
+    struct Skip
+    {
+        uint64_t first;                     // first row of the block
+        uint64_t offset;                    // of its differences in bytes
+    };
+
+    const unsigned char *data;              // mapped file, or nullptr
+    size_t length;                          // bytes mapped
+    int k;                                  // subgraph size
+    long long rows;                         // rows of the indexed file
+    uint32_t vertices;                      // vertex slots
+    uint32_t classCount;                    // entries of classes
+    const ClassRange *classes;              // ascending by type
+    const uint64_t *postings;               // running postings per vertex
+    const uint64_t *blocks;                 // running blocks per vertex
+    const Skip *skips;                      // one per block
+    const unsigned char *bytes;             // varint differences
+
+};
+
+#endif /* defined(__NemoSQL__InstanceIndex__) */
@@ -0,0 +1,681 @@
+//------------------------------------------------------------------------------
+//  LevelWise.cpp
+//------------------------------------------------------------------------------
+// LevelWise finds the connected size-k subgraphs of a Graph one size at a
+// time, extending every k-set of the previous level by its neighbors and
+// removing duplicates with a radix sort.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a LevelWise refers to it
+//
+//------------------------------------------------------------------------------
+
+#include "LevelWise.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <unistd.h>
+#include "Checkpoint.h"
+
+static const char MAGIC[8] = {'N', 'E', 'M', 'O', 'L', 'E', 'V', 'L'};
+static const uint32_t VERSION = 1;
+static const int DIGIT_BITS = 11;           // widest radix digit
+static const int TUPLE_CHUNK = 4096;        // rows extended per grab
+
+//---------------------------------- radixSort ---------------------------------
+// Sorts fixed-width rows of vertex IDs
+// Preconditions: rows holds whole rows of width values, each below 2^bits
+// Postconditions: The rows are in ascending lexicographic order
+static void radixSort(vector<uint32_t> &rows, const int &width,
+                      const int &bits)
+{
+    const size_t count = rows.size() / width;
+    if (count < 2)
+        return;
+
+    // Digits of at most DIGIT_BITS bits keep the histogram in cache
+    const int passes = max(1, (bits + DIGIT_BITS - 1) / DIGIT_BITS);
+    const int digitBits = (bits + passes - 1) / passes;
+    const size_t buckets = (size_t)1 << digitBits;
+    const uint32_t digitMask = (uint32_t)(buckets - 1);
+
+    vector<size_t> offsets(buckets);
+    vector<uint32_t> scratch(rows.size());
+
+    // Stable passes from the least significant digit of the last column
+    for (int column = width - 1; column >= 0; column--)
+        for (int pass = 0; pass < passes; pass++)
+        {
+            const int shift = pass * digitBits;
+
+            fill(offsets.begin(), offsets.end(), 0);
+            for (size_t row = 0; row < count; row++)
+                offsets[rows[row * width + column] >> shift & digitMask]++;
+
+            // A digit shared by every row leaves the order as it is
+            size_t total = 0;
+            bool single = false;
+            for (size_t bucket = 0; bucket < buckets; bucket++)
+            {
+                single = single || offsets[bucket] == count;
+                size_t rowsHere = offsets[bucket];
+                offsets[bucket] = total;
+                total += rowsHere;
+            }
+            if (single)
+                continue;
+
+            for (size_t row = 0; row < count; row++)
+            {
+                const uint32_t *from = &rows[row * width];
+                size_t to = offsets[from[column] >> shift & digitMask]++;
+                copy(from, from + width, &scratch[to * width]);
+            }
+
+            rows.swap(scratch);
+        }
+}
+
+//----------------------------------- unique -----------------------------------
+// Removes repeated rows
+// Preconditions: rows holds whole sorted rows of width values
+// Postconditions: Every row is kept once, in order
+static void unique(vector<uint32_t> &rows, const int &width)
+{
+    const size_t count = rows.size() / width;
+    size_t kept = 0;
+
+    for (size_t row = 0; row < count; row++)
+    {
+        const uint32_t *from = &rows[row * width];
+        if (kept > 0 && equal(from, from + width, &rows[(kept - 1) * width]))
+            continue;
+
+        if (kept != row)
+            copy(from, from + width, &rows[kept * width]);
+        kept++;
+    }
+
+    rows.resize(kept * width);
+}
+
+//--------------------------------- writeHeader --------------------------------
+// Writes the header of a level file
+// Preconditions: file is open for writing at its start
+// Postconditions: Returns false if the header could not be written
+static bool writeHeader(FILE *file, const int32_t &size,
+                        const int32_t &vertices, const uint64_t &fingerprint,
+                        const uint64_t &rows)
+{
+    return fwrite(MAGIC, 1, sizeof(MAGIC), file) == sizeof(MAGIC) &&
+           fwrite(&VERSION, sizeof(VERSION), 1, file) == 1 &&
+           fwrite(&size, sizeof(size), 1, file) == 1 &&
+           fwrite(&vertices, sizeof(vertices), 1, file) == 1 &&
+           fwrite(&fingerprint, sizeof(fingerprint), 1, file) == 1 &&
+           fwrite(&rows, sizeof(rows), 1, file) == 1;
+}
+
+//--------------------------------- readHeader ---------------------------------
+// Reads the header of a level file made for graph
+// Preconditions: file is open for reading at its start
+// Postconditions: Returns false if the file is not a level of graph;
+//                 otherwise size and rows are set and the file is at the
+//                 first row
+static bool readHeader(FILE *file, const Graph &graph, int32_t &size,
+                       uint64_t &rows)
+{
+    char magic[sizeof(MAGIC)];
+    uint32_t version;
+    int32_t vertices;
+    uint64_t fingerprint;
+
+    return fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+           memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 &&
+           fread(&version, sizeof(version), 1, file) == 1 &&
+           version == VERSION &&
+           fread(&size, sizeof(size), 1, file) == 1 &&
+           fread(&vertices, sizeof(vertices), 1, file) == 1 &&
+           fread(&fingerprint, sizeof(fingerprint), 1, file) == 1 &&
+           fread(&rows, sizeof(rows), 1, file) == 1 &&
+           size >= 2 && size <= MAX_SUBGRAPH_SIZE &&
+           vertices == graph.size() &&
+           fingerprint == Checkpoint::fingerprintOf(graph);
+}
+
+//------------------------------------------------------------------------------
+// Sequential reader of the rows of a level or run file, a block at a time
+class RowReader
+{
+public:
+    RowReader(FILE *file, const int &width, const size_t &blockBytes)
+        : file(file), width(width),
+          block(max((size_t)width, blockBytes / sizeof(uint32_t) / width *
+                                       width)) {}
+
+    ~RowReader()
+    {
+        fclose(file);
+    }
+
+    // Moves to the next row; returns false at the end of the file
+    bool next()
+    {
+        pos += width;
+        if (pos >= filled)
+        {
+            filled = fread(block.data(), sizeof(uint32_t), block.size(), file);
+            filled -= filled % width;
+            pos = 0;
+        }
+        return pos < filled;
+    }
+
+    // The current row
+    const uint32_t *row() const
+    {
+        return &block[pos];
+    }
+
+private:
+    FILE *file;                             // owned, positioned at the rows
+    int width;                              // values per row
+    vector<uint32_t> block;                 // rows read ahead
+    size_t pos = 0, filled = 0;             // current row, values in block
+};
+
+//---------------------------------- mergeRuns ---------------------------------
+// Merges sorted run files into out, dropping repeated rows
+// Preconditions: every file in runs holds sorted rows of width values, all
+//                above the rows already in out
+// Postconditions: Returns false on an I/O error; the runs are deleted and
+//                 written is increased by the rows written
+static bool mergeRuns(const vector<string> &runs, const int &width,
+                      const size_t &blockBytes, FILE *out, uint64_t &written)
+{
+    vector<RowReader *> readers;
+    bool ok = true;
+    for (const string &run : runs)
+    {
+        FILE *file = fopen(run.c_str(), "rb");
+        if (file == nullptr)
+        {
+            ok = false;
+            continue;
+        }
+        readers.push_back(new RowReader(file, width, blockBytes));
+    }
+
+    // Min-heap of readers by their current row
+    auto above = [&](const int &a, const int &b)
+    {
+        return lexicographical_compare(readers[b]->row(),
+                                       readers[b]->row() + width,
+                                       readers[a]->row(),
+                                       readers[a]->row() + width);
+    };
+    priority_queue<int, vector<int>, decltype(above)> heap(above);
+    for (int i = 0; ok && i < (int)readers.size(); i++)
+        if (readers[i]->next())
+            heap.push(i);
+
+    vector<uint32_t> previous(width);
+    bool any = false;
+    while (ok && !heap.empty())
+    {
+        int i = heap.top();
+        heap.pop();
+
+        const uint32_t *row = readers[i]->row();
+        if (!any || !equal(row, row + width, previous.begin()))
+        {
+            ok = fwrite(row, sizeof(uint32_t), width, out) == (size_t)width;
+            copy(row, row + width, previous.begin());
+            written++;
+            any = true;
+        }
+
+        if (readers[i]->next())
+            heap.push(i);
+    }
+
+    for (RowReader *reader : readers)
+        delete reader;
+    for (const string &run : runs)
+        remove(run.c_str());
+
+    return ok;
+}
+
+//--------------------------------- Constructor --------------------------------
+// Creates a level-wise search over graph
+// Preconditions: None
+// Postconditions: The current level is empty, of size 0
+LevelWise::LevelWise(const Graph &graph)
+    : graph(graph), k(0), generated(0), runs(0) {}
+
+//------------------------------------ start -----------------------------------
+// Makes the edges the current level
+// Preconditions: None
+// Postconditions: The current level holds every edge as a size-2 row
+void LevelWise::start()
+{
+    tuples.clear();
+    for (int u = 0; u < graph.size(); u++)
+    {
+        vector<int> above;
+        for (int v : graph.neighbors(u))
+            if (v > u)
+                above.push_back(v);
+
+        sort(above.begin(), above.end());
+        for (int v : above)
+        {
+            tuples.push_back(u);
+            tuples.push_back(v);
+        }
+    }
+
+    k = 2;
+    generated = getCount();
+}
+
+//------------------------------------ extend ----------------------------------
+// Replaces the current level of size k by the level of size k + 1
+// Preconditions: start or load succeeded; threads >= 1
+// Postconditions: The current level holds every connected (k+1)-set once,
+//                 rows ascending
+void LevelWise::extend(const int &threads)
+{
+    const long long count = getCount();
+    const int width = k + 1;
+
+    // Ranges of about TUPLE_CHUNK rows that never split a group of rows
+    // with the same first vertex
+    vector<long long> bounds(1, 0);
+    for (long long row = TUPLE_CHUNK; row < count; row++)
+    {
+        if (row - bounds.back() < TUPLE_CHUNK ||
+            tuples[row * k] == tuples[(row - 1) * k])
+            continue;
+        bounds.push_back(row);
+    }
+    bounds.push_back(count);
+
+    const int bits = vertexBits();
+    const int ranges = (int)bounds.size() - 1;
+    vector<vector<uint32_t>> parts(max(ranges, 0));
+    vector<vector<long long>> marks(threads);
+    vector<long long> made(threads, 0);
+
+    parallelFor(0, ranges, threads, 1, [&](int thread, int begin, int end)
+    {
+        vector<long long> &seen = marks[thread];
+        if (seen.empty())
+            seen.assign(graph.size(), -1);
+
+        for (int range = begin; range < end; range++)
+        {
+            vector<uint32_t> &out = parts[range];
+
+            for (long long row = bounds[range]; row < bounds[range + 1]; row++)
+                extendRow(&tuples[row * k], k, row, seen, out);
+
+            made[thread] += out.size() / width;
+            radixSort(out, width, bits);
+            unique(out, width);
+            out.shrink_to_fit();
+        }
+    });
+
+    generated = 0;
+    size_t total = 0;
+    for (int thread = 0; thread < threads; thread++)
+        generated += made[thread];
+    for (const vector<uint32_t> &part : parts)
+        total += part.size();
+
+    // Ranges hold ascending first vertices, so their rows are already in
+    // order one after the other
+    vector<uint32_t> next;
+    next.reserve(total);
+    for (vector<uint32_t> &part : parts)
+    {
+        next.insert(next.end(), part.begin(), part.end());
+        vector<uint32_t>().swap(part);
+    }
+
+    tuples.swap(next);
+    k = width;
+}
+
+//------------------------------------- save -----------------------------------
+// Atomically replaces the file at path with the current level
+// Preconditions: None
+// Postconditions: Returns true if the new file is in place
+bool LevelWise::save(const string &path) const
+{
+    string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    bool written =
+        writeHeader(file, k, graph.size(), Checkpoint::fingerprintOf(graph),
+                    getCount()) &&
+        fwrite(tuples.data(), sizeof(uint32_t), tuples.size(), file) ==
+            tuples.size() &&
+        fflush(file) == 0 && fsync(fileno(file)) == 0;
+    written = fclose(file) == 0 && written;
+
+    if (!written || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------- load -----------------------------------
+// Reads a level saved for this graph
+// Preconditions: None
+// Postconditions: Returns true and makes it the current level if path holds a
+//                 level of this graph; otherwise returns false and leaves the
+//                 current level unchanged
+bool LevelWise::load(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    int32_t size;
+    uint64_t rows;
+    bool ok = readHeader(file, graph, size, rows);
+
+    vector<uint32_t> loaded;
+    if (ok)
+    {
+        loaded.resize(rows * size);
+        ok = fread(loaded.data(), sizeof(uint32_t), loaded.size(), file) ==
+                 loaded.size() &&
+             fgetc(file) == EOF;
+    }
+    fclose(file);
+
+    if (!ok)
+        return false;
+
+    tuples.swap(loaded);
+    k = size;
+    generated = 0;
+    return true;
+}
+
+//------------------------------------ probe -----------------------------------
+// Reads the size of a level saved for this graph, without its rows
+// Preconditions: None
+// Postconditions: Returns false if path is not a level of this graph;
+//                 otherwise size and rows are set
+bool LevelWise::probe(const string &path, int &size, long long &rows) const
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    int32_t saved;
+    uint64_t count;
+    bool ok = readHeader(file, graph, saved, count);
+    fclose(file);
+
+    if (ok)
+    {
+        size = saved;
+        rows = (long long)count;
+    }
+    return ok;
+}
+
+//--------------------------------- extendFile ---------------------------------
+// Extends the level saved at from into a level saved at to, in bounded memory
+// Preconditions: from holds a level of this graph of size below
+//                MAX_SUBGRAPH_SIZE
+// Postconditions: Returns the number of rows written to to, or -1 if from is
+//                 not a level of this graph or an I/O error occurred; the
+//                 current level is not changed
+long long LevelWise::extendFile(const string &from, const string &to,
+                                const SpillOptions &options)
+{
+    FILE *in = fopen(from.c_str(), "rb");
+    int32_t size;
+    uint64_t count;
+    if (in == nullptr)
+        return -1;
+    if (!readHeader(in, graph, size, count) || size >= MAX_SUBGRAPH_SIZE)
+    {
+        fclose(in);
+        return -1;
+    }
+
+    string temporary = to + ".tmp";
+    FILE *out = fopen(temporary.c_str(), "wb");
+    if (out == nullptr)
+    {
+        fclose(in);
+        return -1;
+    }
+    vector<char> outBlock(max((size_t)BUFSIZ, options.blockBytes));
+    setvbuf(out, outBlock.data(), _IOFBF, outBlock.size());
+
+    const int width = size + 1;
+    const uint64_t fingerprint = Checkpoint::fingerprintOf(graph);
+    bool ok = writeHeader(out, width, graph.size(), fingerprint, 0);
+
+    // New rows and the sort's scratch copy share the memory budget
+    const size_t limit = max((size_t)width, options.memoryBytes / 2 /
+                                                sizeof(uint32_t));
+
+    vector<uint32_t> buffer;
+    vector<string> pending;
+    vector<long long> seen(graph.size(), -1);
+    uint64_t written = 0;
+    generated = 0;
+    runs = 0;
+
+    // Before every row the buffer is flushed if it is full: into out at the
+    // start of a new first vertex, whose rows are all above those buffered,
+    // or as a sorted run inside a group, whose rows may still repeat. Runs
+    // are merged into out at the next flush at a group boundary
+    RowReader parents(in, size, options.blockBytes);
+    uint32_t group = 0;
+    for (long long row = 0; ok && parents.next(); row++)
+    {
+        const uint32_t *tuple = parents.row();
+
+        if (buffer.size() >= limit)
+        {
+            bool boundary = tuple[0] != group;
+            ok = boundary ? flush(buffer, width, pending, options, out, written)
+                          : spill(buffer, width, pending, options);
+        }
+
+        group = tuple[0];
+        extendRow(tuple, size, row, seen, buffer);
+    }
+
+    ok = ok && flush(buffer, width, pending, options, out, written);
+    for (const string &run : pending)
+        remove(run.c_str());
+
+    // The row count is only known now; it ends the header
+    const long rowsAt = sizeof(MAGIC) + sizeof(VERSION) + 2 * sizeof(int32_t) +
+                        sizeof(uint64_t);
+    ok = ok && fseek(out, rowsAt, SEEK_SET) == 0 &&
+         fwrite(&written, sizeof(written), 1, out) == 1 && fflush(out) == 0 &&
+         fsync(fileno(out)) == 0;
+    ok = fclose(out) == 0 && ok;
+
+    if (!ok || rename(temporary.c_str(), to.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return -1;
+    }
+
+    return (long long)written;
+}
+
+//----------------------------------- getSize ----------------------------------
+// Subgraph size of the current level
+// Preconditions: None
+// Postconditions: Returns k, or 0 before start or load
+int LevelWise::getSize() const
+{
+    return k;
+}
+
+//---------------------------------- getCount ----------------------------------
+// Number of subgraphs in the current level
+// Preconditions: None
+// Postconditions: Returns the number of rows
+long long LevelWise::getCount() const
+{
+    return k == 0 ? 0 : (long long)(tuples.size() / k);
+}
+
+//-------------------------------- getGenerated --------------------------------
+// Work done by the last extend
+// Preconditions: None
+// Postconditions: Returns the number of rows produced before duplicates were
+//                 removed
+long long LevelWise::getGenerated() const
+{
+    return generated;
+}
+
+//----------------------------------- getRuns ----------------------------------
+// Spilling done by the last extendFile
+// Preconditions: None
+// Postconditions: Returns the number of sorted runs written to disk
+long long LevelWise::getRuns() const
+{
+    return runs;
+}
+
+//---------------------------------- getTuples ---------------------------------
+// Rows of the current level
+// Preconditions: None
+// Postconditions: Returns getCount() rows of getSize() ascending vertex IDs,
+//                 one after the other, rows ascending
+const vector<uint32_t> &LevelWise::getTuples() const
+{
+    return tuples;
+}
+
+//----------------------------- PRIVATE: extendRow -----------------------------
+// Appends the extensions of one row to out
+// Preconditions: tuple holds size ascending vertex IDs; stamp differs from
+//                the stamp of every earlier call with the same seen, which
+//                holds graph.size() entries
+// Postconditions: Every (size+1)-row made of tuple and a neighbor above
+//                 tuple[0] is appended once, in ascending order
+void LevelWise::extendRow(const uint32_t *tuple, const int &size,
+                          const long long &stamp, vector<long long> &seen,
+                          vector<uint32_t> &out) const
+{
+    // seen[v] == stamp marks the members and the neighbors already used
+    for (int i = 0; i < size; i++)
+        seen[tuple[i]] = stamp;
+
+    for (int i = 0; i < size; i++)
+        for (int w : graph.neighbors(tuple[i]))
+        {
+            if (seen[w] == stamp || (uint32_t)w < tuple[0])
+                continue;
+            seen[w] = stamp;
+
+            // Insert w at its place in the ascending row
+            int at = 1;
+            while (at < size && tuple[at] < (uint32_t)w)
+                at++;
+
+            out.insert(out.end(), tuple, tuple + at);
+            out.push_back(w);
+            out.insert(out.end(), tuple + at, tuple + size);
+        }
+}
+
+//----------------------------- PRIVATE: vertexBits ----------------------------
+// Bits needed for a vertex ID of the graph
+// Preconditions: None
+// Postconditions: Returns the smallest b >= 1 with graph.size() <= 2^b
+int LevelWise::vertexBits() const
+{
+    int bits = 1;
+    while (bits < 32 && ((long long)1 << bits) < graph.size())
+        bits++;
+
+    return bits;
+}
+
+//------------------------------- PRIVATE: spill -------------------------------
+// Writes the buffered rows to a new sorted run
+// Preconditions: buffer holds whole rows of width values
+// Postconditions: Returns false on an I/O error; otherwise the buffer is
+//                 empty and its sorted, repeat-free rows are in a file
+//                 appended to pending
+bool LevelWise::spill(vector<uint32_t> &buffer, const int &width,
+                      vector<string> &pending, const SpillOptions &options)
+{
+    generated += buffer.size() / width;
+    radixSort(buffer, width, vertexBits());
+    unique(buffer, width);
+
+    string path = options.directory + "/nemo-level-" + to_string(getpid()) +
+                  "-" + to_string(runs) + ".run";
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    pending.push_back(path);
+    runs++;
+
+    bool ok = fwrite(buffer.data(), sizeof(uint32_t), buffer.size(), file) ==
+              buffer.size();
+    ok = fclose(file) == 0 && ok;
+
+    buffer.clear();
+    return ok;
+}
+
+//------------------------------- PRIVATE: flush -------------------------------
+// Writes the buffered rows and the pending runs to out
+// Preconditions: buffer holds whole rows of width values; they and the
+//                pending runs hold every row left of their first-vertex
+//                groups, all above the rows already in out
+// Postconditions: Returns false on an I/O error; otherwise the rows are in
+//                 out once each and in order, written counts them, and the
+//                 buffer and pending are empty
+bool LevelWise::flush(vector<uint32_t> &buffer, const int &width,
+                      vector<string> &pending, const SpillOptions &options,
+                      FILE *out, uint64_t &written)
+{
+    if (!pending.empty())
+    {
+        bool ok = spill(buffer, width, pending, options) &&
+                  mergeRuns(pending, width, options.blockBytes, out, written);
+        pending.clear();
+        return ok;
+    }
+
+    generated += buffer.size() / width;
+    radixSort(buffer, width, vertexBits());
+    unique(buffer, width);
+
+    bool ok = fwrite(buffer.data(), sizeof(uint32_t), buffer.size(), out) ==
+              buffer.size();
+    written += buffer.size() / width;
+
+    buffer.clear();
+    return ok;
+}
@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+//  LevelWise.h
+//------------------------------------------------------------------------------
+// LevelWise finds the connected size-k subgraphs of a Graph breadth first, one
+// size at a time, the way the NemoSQL prototype (NemoSQL_Binary/Graph.py)
+// grows its size<k> tables: every connected (k+1)-set is a connected k-set
+// plus one neighbor of it, so level k+1 is the k-sets of level k extended by
+// each vertex of their neighborhood.
+//
+// A level is stored as fixed-width rows of k ascending vertex IDs, the rows in
+// ascending order. A (k+1)-set is produced once for each of its connected
+// k-subsets that hold its smallest vertex (a k-set is only extended by
+// vertices above its first one), and every such subset starts with that
+// vertex too. The duplicates of a new row therefore all come from rows with
+// the same first vertex, so the level is cut into ranges of whole first-vertex
+// groups, and each range is extended, LSD radix sorted and freed of repeated
+// rows on its own, the ranges in parallel. The ranges' results are already in
+// order one after the other. Unlike the prototype's bitmask key, a row costs
+// k integers whatever the number of vertices in the graph.
+//
+// Levels can be saved and loaded, so a run for size k + 1 can continue from a
+// stored level k instead of starting again from the edges. File layout
+// (little endian, as written by the host):
+//   char[8]   "NEMOLEVL"
+//   uint32    version
+//   int32     k
+//   int32     number of vertex slots of the graph
+//   uint64    graph fingerprint (see Checkpoint::fingerprintOf)
+//   uint64    number of rows, then that many rows of k uint32 vertex IDs
+//
+// When levels outgrow memory, extendFile extends a saved level into another
+// saved level without holding either: the old level is streamed in large
+// blocks, new rows are buffered up to a memory budget, and a full buffer is
+// sorted and deduplicated. At the start of a new first-vertex group it is
+// appended to the output straight away; inside a group (a hub whose rows alone
+// exceed the budget) it is spilled as a sorted run file, and the group's runs
+// are combined by a k-way merge that drops repeated rows as it writes. Memory
+// stays at the budget plus one read block per run.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a LevelWise refers to it
+//   -- extend needs memory for the old level and twice the new one
+//
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__LevelWise__
+#define __NemoSQL__LevelWise__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "Parallel.h"
+
+using namespace std;
+
+struct SpillOptions
+{
+    string directory = ".";                 // where sorted runs are written
+    size_t memoryBytes = (size_t)1 << 30;   // buffered new rows, sort included
+    size_t blockBytes = 1 << 22;            // bytes per read or write
+};
+
+class LevelWise
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a level-wise search over graph
+    // Preconditions: None
+    // Postconditions: The current level is empty, of size 0
+    LevelWise(const Graph &graph);
+
+
+    //---------------------------------- start ---------------------------------
+    // Makes the edges the current level
+    // Preconditions: None
+    // Postconditions: The current level holds every edge as a size-2 row
+    void start();
+
+
+    //---------------------------------- extend --------------------------------
+    // Replaces the current level of size k by the level of size k + 1
+    // Preconditions: start or load succeeded; threads >= 1
+    // Postconditions: The current level holds every connected (k+1)-set
+    //                 once, rows ascending
+    void extend(const int &threads = defaultThreads());
+
+
+    //----------------------------------- save ---------------------------------
+    // Atomically replaces the file at path with the current level
+    // Preconditions: None
+    // Postconditions: Returns true if the new file is in place
+    bool save(const string &path) const;
+
+
+    //----------------------------------- load ---------------------------------
+    // Reads a level saved for this graph
+    // Preconditions: None
+    // Postconditions: Returns true and makes it the current level if path
+    //                 holds a level of this graph; otherwise returns false
+    //                 and leaves the current level unchanged
+    bool load(const string &path);
+
+
+    //----------------------------------- probe --------------------------------
+    // Reads the size of a level saved for this graph, without its rows
+    // Preconditions: None
+    // Postconditions: Returns false if path is not a level of this graph;
+    //                 otherwise size and rows are set
+    bool probe(const string &path, int &size, long long &rows) const;
+
+
+    //-------------------------------- extendFile ------------------------------
+    // Extends the level saved at from into a level saved at to, in bounded
+    // memory
+    // Preconditions: from holds a level of this graph of size below
+    //                MAX_SUBGRAPH_SIZE
+    // Postconditions: Returns the number of rows written to to, or -1 if from
+    //                 is not a level of this graph or an I/O error occurred;
+    //                 the current level is not changed
+    long long extendFile(const string &from, const string &to,
+                         const SpillOptions &options = SpillOptions());
+
+
+    //--------------------------------- getSize --------------------------------
+    // Subgraph size of the current level
+    // Preconditions: None
+    // Postconditions: Returns k, or 0 before start or load
+    int getSize() const;
+
+
+    //--------------------------------- getCount -------------------------------
+    // Number of subgraphs in the current level
+    // Preconditions: None
+    // Postconditions: Returns the number of rows
+    long long getCount() const;
+
+
+    //------------------------------- getGenerated -----------------------------
+    // Work done by the last extend
+    // Preconditions: None
+    // Postconditions: Returns the number of rows produced before duplicates
+    //                 were removed
+    long long getGenerated() const;
+
+
+    //--------------------------------- getRuns --------------------------------
+    // Spilling done by the last extendFile
+    // Preconditions: None
+    // Postconditions: Returns the number of sorted runs written to disk
+    long long getRuns() const;
+
+
+    //-------------------------------- getTuples -------------------------------
+    // Rows of the current level
+    // Preconditions: None
+    // Postconditions: Returns getCount() rows of getSize() ascending vertex
+    //                 IDs, one after the other, rows ascending
+    const vector<uint32_t> &getTuples() const;
+
+
+private:
+    const Graph &graph;                     // graph being searched
+    int k;                                  // size of the current level
+    vector<uint32_t> tuples;                // rows of the current level
+    long long generated;                    // rows made by the last extend
+    long long runs;                         // runs spilled by extendFile
+
+
+    //---------------------------- PRIVATE: extendRow --------------------------
+    // Appends the extensions of one row to out
+    // Preconditions: tuple holds size ascending vertex IDs; stamp differs
+    //                from the stamp of every earlier call with the same seen,
+    //                which holds graph.size() entries
+    // Postconditions: Every (size+1)-row made of tuple and a neighbor above
+    //                 tuple[0] is appended once, in ascending order
+    void extendRow(const uint32_t *tuple, const int &size,
+                   const long long &stamp, vector<long long> &seen,
+                   vector<uint32_t> &out) const;
+
+
+    //---------------------------- PRIVATE: vertexBits -------------------------
+    // Bits needed for a vertex ID of the graph
+    // Preconditions: None
+    // Postconditions: Returns the smallest b >= 1 with graph.size() <= 2^b
+    int vertexBits() const;
+
+
+    //------------------------------ PRIVATE: spill ----------------------------
+    // Writes the buffered rows to a new sorted run
+    // Preconditions: buffer holds whole rows of width values
+    // Postconditions: Returns false on an I/O error; otherwise the buffer is
+    //                 empty and its sorted, repeat-free rows are in a file
+    //                 appended to pending
+    bool spill(vector<uint32_t> &buffer, const int &width,
+               vector<string> &pending, const SpillOptions &options);
+
+
+    //------------------------------ PRIVATE: flush ----------------------------
+    // Writes the buffered rows and the pending runs to out
+    // Preconditions: buffer holds whole rows of width values; they and the
+    //                pending runs hold every row left of their first-vertex
+    //                groups, all above the rows already in out
+    // Postconditions: Returns false on an I/O error; otherwise the rows are
+    //                 in out once each and in order, written counts them, and
+    //                 the buffer and pending are empty
+    bool flush(vector<uint32_t> &buffer, const int &width,
+               vector<string> &pending, const SpillOptions &options,
+               FILE *out, uint64_t &written);
+
+};
+
+#endif /* defined(__NemoSQL__LevelWise__) */
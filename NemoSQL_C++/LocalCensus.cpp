@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+//  LocalCensus.cpp
+//------------------------------------------------------------------------------
+// LocalCensus counts, per class, the connected size-k subgraphs of a Graph
+// that contain at least one vertex of a seed set.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a LocalCensus refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "LocalCensus.h"
+
+#include <algorithm>
+
+//--------------------------------- Constructor --------------------------------
+// Creates a census of the size-k subgraphs of graph around seed sets
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Nothing is counted yet
+LocalCensus::LocalCensus(const Graph &graph, const int &k)
+    : graph(graph), k(k), classifier(k) {}
+
+//------------------------------------- run ------------------------------------
+// Counts the subgraphs that contain a vertex of seeds
+// Preconditions: None
+// Postconditions: getCounts() holds the census of the connected size-k
+//                 subgraphs with at least one seed, each counted once;
+//                 repeated seeds and seeds outside the graph are ignored. If
+//                 instances is given, one "vertices graph6" line per subgraph
+//                 is written to it, vertices ascending
+void LocalCensus::run(const vector<int> &seeds, ostream *instances)
+{
+    vector<int> distinct;
+    for (int seed : seeds)
+        if (seed >= 0 && seed < graph.size())
+            distinct.push_back(seed);
+    sort(distinct.begin(), distinct.end());
+    distinct.erase(unique(distinct.begin(), distinct.end()), distinct.end());
+
+    counts.clear();
+    total = 0;
+    this->instances = instances;
+
+    if ((int)state.adjacent.size() != graph.size())
+        state.reset(k, graph.size());
+    graph.enumerateAround(distinct.data(), (int)distinct.size(), k, *this,
+                          state);
+
+    this->instances = nullptr;
+}
+
+//---------------------------------- getCounts ---------------------------------
+// Census of the last run
+// Preconditions: None
+// Postconditions: Returns canonical mask -> number of instances
+const ClassCounts &LocalCensus::getCounts() const
+{
+    return counts;
+}
+
+//---------------------------------- getTotal ----------------------------------
+// Number of subgraphs counted by the last run
+// Preconditions: None
+// Postconditions: Returns the sum of getCounts()
+long long LocalCensus::getTotal() const
+{
+    return total;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes one "graph6 count" line per class
+// Preconditions: None
+// Postconditions: The census of the last run is written to out
+void LocalCensus::write(ostream &out) const
+{
+    for (const auto &entry : counts)
+        out << Classifier::toGraph6(entry.first, k) << "\t" << entry.second
+            << "\n";
+}
+
+//------------------------------------ visit -----------------------------------
+// Counts one subgraph around the seeds
+// Preconditions: called by Graph::enumerateAround during run; mask is the
+//                packed adjacency of subgraph
+// Postconditions: The count of the class of mask is one more
+void LocalCensus::visit(const int *subgraph, const int &k,
+                        const uint64_t &mask)
+{
+    uint64_t type = classifier.classify(mask);
+    counts[type]++;
+    total++;
+
+    if (instances == nullptr)
+        return;
+
+    int sorted[MAX_SUBGRAPH_SIZE];
+    copy(subgraph, subgraph + k, sorted);
+    sortSmall(sorted, k);
+
+    for (int i = 0; i < k; i++)
+        *instances << sorted[i] << "\t";
+    *instances << Classifier::toGraph6(type, k) << "\n";
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+//  LocalCensus.h
+//------------------------------------------------------------------------------
+// LocalCensus counts, per class, the connected size-k subgraphs of a Graph
+// that contain at least one vertex of a seed set, such as a handful of
+// proteins of interest, without enumerating the rest of the graph.
+//
+// Each seed is the contracted root of a seeded search (Graph::enumerateAround)
+// that leaves out the seeds before it, so a subgraph holding several seeds is
+// counted once, from the first of them. The work is that of the subgraphs
+// found, not of the whole graph.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a LocalCensus refers to it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__LocalCensus__
+#define __NemoSQL__LocalCensus__
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Checkpoint.h"
+#include "Classifier.h"
+#include "Enumeration.h"
+#include "Graph.h"
+
+using namespace std;
+
+class LocalCensus
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a census of the size-k subgraphs of graph around seed sets
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Nothing is counted yet
+    LocalCensus(const Graph &graph, const int &k);
+
+
+    //----------------------------------- run ----------------------------------
+    // Counts the subgraphs that contain a vertex of seeds
+    // Preconditions: None
+    // Postconditions: getCounts() holds the census of the connected size-k
+    //                 subgraphs with at least one seed, each counted once;
+    //                 repeated seeds and seeds outside the graph are ignored.
+    //                 If instances is given, one "vertices graph6" line per
+    //                 subgraph is written to it, vertices ascending
+    void run(const vector<int> &seeds, ostream *instances = nullptr);
+
+
+    //-------------------------------- getCounts -------------------------------
+    // Census of the last run
+    // Preconditions: None
+    // Postconditions: Returns canonical mask -> number of instances
+    const ClassCounts &getCounts() const;
+
+
+    //-------------------------------- getTotal --------------------------------
+    // Number of subgraphs counted by the last run
+    // Preconditions: None
+    // Postconditions: Returns the sum of getCounts()
+    long long getTotal() const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes one "graph6 count" line per class
+    // Preconditions: None
+    // Postconditions: The census of the last run is written to out
+    void write(ostream &out) const;
+
+
+    //---------------------------------- visit ---------------------------------
+    // Counts one subgraph around the seeds
+    // Preconditions: called by Graph::enumerateAround during run; mask is
+    //                the packed adjacency of subgraph
+    // Postconditions: The count of the class of mask is one more
+    void visit(const int *subgraph, const int &k, const uint64_t &mask);
+
+
+private:
+    const Graph &graph;                     // graph being searched
+    int k;                                  // subgraph size
+    ClassCounts counts;                     // census of the last run
+    long long total = 0;                    // sum of counts
+    Classifier classifier;                  // class cache
+    EnumerationState state;                 // enumeration buffers
+    ostream *instances = nullptr;           // where instances go, if anywhere
+
+};
+
+#endif /* defined(__NemoSQL__LocalCensus__) */
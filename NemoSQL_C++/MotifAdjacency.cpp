@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+//  MotifAdjacency.cpp
+//------------------------------------------------------------------------------
+// MotifAdjacency computes the motif adjacency matrix of a Graph: for every
+// edge (u, v), the number of induced instances of one chosen size-k motif that
+// contain both u and v as an edge of the instance.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a MotifAdjacency refers to it
+//   -- the motif is given as a canonical mask (see Classifier)
+//
+//------------------------------------------------------------------------------
+
+#include "MotifAdjacency.h"
+
+#include <algorithm>
+#include "EdgeSet.h"
+#include "Parallel.h"
+
+//--------------------------------- Constructor --------------------------------
+// Creates a motif adjacency computation over graph
+// Preconditions: motif is the canonical mask of a connected size-k graph
+// Postconditions: No weights are computed yet
+MotifAdjacency::MotifAdjacency(const Graph &graph, const int &k,
+                               const uint64_t &motif)
+    : graph(graph), k(k), motif(motif) {}
+
+//----------------------------- Worker Constructor -----------------------------
+// Per-thread visitor for size-k instances of motif in an n-vertex graph
+// Preconditions: None
+// Postconditions: No edge has been credited yet
+MotifAdjacency::Worker::Worker(const int &k, const uint64_t &motif,
+                               const int &n)
+    : motif(motif), classifier(k)
+{
+    state.reset(k, n);
+}
+
+//----------------------------------- compute ----------------------------------
+// Computes the weight of every edge of the graph
+// Preconditions: threads >= 1
+// Postconditions: getEdges() holds every edge with a non-zero weight,
+//                 sorted by (from, to)
+void MotifAdjacency::compute(const int &threads)
+{
+    vector<Accumulator> accumulators(threads);
+
+    if (k == 3 && motif == Classifier::canonical((1 << 3) - 1, 3))
+        countTriangles(accumulators, threads);
+    else if (k == 4 && motif == Classifier::canonical((1 << 6) - 1, 4))
+        countCliques4(accumulators, threads);
+    else
+        countInstances(accumulators, threads);
+
+    // Each edge may have been credited by several threads; fold them together
+    Accumulator &total = accumulators[0];
+    for (int t = 1; t < threads; t++)
+    {
+        for (auto &entry : accumulators[t])
+            total[entry.first] += entry.second;
+        Accumulator().swap(accumulators[t]);
+    }
+
+    edges.clear();
+    edges.reserve(total.size());
+    for (auto &entry : total)
+        edges.push_back({(int)(entry.first >> 32), (int)(uint32_t)entry.first,
+                         entry.second});
+
+    sort(edges.begin(), edges.end(), [](const WeightedEdge &a,
+                                        const WeightedEdge &b)
+    {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+}
+
+//---------------------------------- getEdges ----------------------------------
+// Weighted edges found by the last compute
+// Preconditions: None
+// Postconditions: Returns the weighted edge list
+const vector<WeightedEdge> &MotifAdjacency::getEdges() const
+{
+    return edges;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes the weighted edge list, one "from to weight" line per edge
+// Preconditions: compute has been called
+// Postconditions: The edge list is written to out
+void MotifAdjacency::write(ostream &out) const
+{
+    for (const WeightedEdge &edge : edges)
+        out << edge.from << "\t" << edge.to << "\t" << edge.weight << "\n";
+}
+
+//--------------------------- PRIVATE: countTriangles --------------------------
+// Weight of (u, v) is the number of common neighbors of u and v
+// Preconditions: The motif is the triangle
+// Postconditions: The weights of all edges are in accumulators
+void MotifAdjacency::countTriangles(vector<Accumulator> &accumulators,
+                                    const int &threads)
+{
+    parallelFor(0, graph.size(), threads, ROOT_CHUNK,
+                [&](int thread, int begin, int end)
+    {
+        for (int u = begin; u < end; u++)
+        {
+            for (int v : graph.neighbors(u))
+            {
+                if (v < u)
+                    continue;
+
+                // Walk the smaller neighborhood and probe the larger one
+                int small = u, large = v;
+                if (graph.neighbors(small).size() > graph.neighbors(large).size())
+                    swap(small, large);
+
+                long long common = 0;
+                for (int w : graph.neighbors(small))
+                    if (graph.isEdge(large, w))
+                        common++;
+
+                if (common > 0)
+                    accumulators[thread][edgeKey(u, v)] = common;
+            }
+        }
+    });
+}
+
+//--------------------------- PRIVATE: countCliques4 ---------------------------
+// Weight of (u, v) is the number of edges among common neighbors of u, v
+// Preconditions: The motif is the 4-clique
+// Postconditions: The weights of all edges are in accumulators
+void MotifAdjacency::countCliques4(vector<Accumulator> &accumulators,
+                                   const int &threads)
+{
+    parallelFor(0, graph.size(), threads, ROOT_CHUNK,
+                [&](int thread, int begin, int end)
+    {
+        vector<int> common;
+
+        for (int u = begin; u < end; u++)
+        {
+            for (int v : graph.neighbors(u))
+            {
+                if (v < u)
+                    continue;
+
+                common.clear();
+                for (int w : graph.neighbors(u))
+                    if (w != v && graph.isEdge(v, w))
+                        common.push_back(w);
+
+                long long cliques = 0;
+                for (size_t a = 0; a < common.size(); a++)
+                    for (size_t b = a + 1; b < common.size(); b++)
+                        if (graph.isEdge(common[a], common[b]))
+                            cliques++;
+
+                if (cliques > 0)
+                    accumulators[thread][edgeKey(u, v)] = cliques;
+            }
+        }
+    });
+}
+
+//--------------------------- PRIVATE: countInstances --------------------------
+// Enumerates every size-k subgraph and credits the edges of motif instances
+// Preconditions: None
+// Postconditions: The weights of all edges are in accumulators
+void MotifAdjacency::countInstances(vector<Accumulator> &accumulators,
+                                    const int &threads)
+{
+    vector<Worker *> workers(threads, nullptr);
+
+    parallelFor(0, graph.size(), threads, ROOT_CHUNK,
+                [&](int thread, int begin, int end)
+    {
+        if (workers[thread] == nullptr)
+            workers[thread] = new Worker(k, motif, graph.size());
+
+        for (int root = begin; root < end; root++)
+            graph.enumerateRoot(root, k, *workers[thread],
+                                workers[thread]->state);
+    });
+
+    for (int t = 0; t < threads; t++)
+    {
+        if (workers[t] != nullptr)
+            accumulators[t].swap(workers[t]->weights);
+        delete workers[t];
+    }
+}
+
+//------------------------------- Worker: visit --------------------------------
+// Adds one to every edge of a size-k instance of the motif
+// Preconditions: mask is the packed adjacency of subgraph
+// Postconditions: If the subgraph is the motif, its edges are credited
+void MotifAdjacency::Worker::visit(const int *subgraph, const int &k,
+                                   const uint64_t &mask)
+{
+    if (classifier.classify(mask) != motif)
+        return;
+
+    for (int j = 1; j < k; j++)
+        for (int i = 0; i < j; i++)
+            if (mask >> pairBit(i, j) & 1)
+                weights[edgeKey(subgraph[i], subgraph[j])]++;
+}
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+//  MotifAdjacency.h
+//------------------------------------------------------------------------------
+// MotifAdjacency computes the motif adjacency matrix of a Graph: for every
+// edge (u, v), the number of induced instances of one chosen size-k motif that
+// contain both u and v as an edge of the instance. The result is a weighted
+// edge list in the same vertex IDs as the buildGraph input, ready to be fed to
+// motif-based spectral clustering.
+// features are included:
+//   -- closed-form counting for the triangle and the 4-clique
+//   -- any other connected motif through a parallel subgraph enumeration that
+//      accumulates into per-thread sparse edge maps
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a MotifAdjacency refers to it
+//   -- the motif is given as a canonical mask (see Classifier)
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__MotifAdjacency__
+#define __NemoSQL__MotifAdjacency__
+
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include "Classifier.h"
+#include "Graph.h"
+
+using namespace std;
+
+struct WeightedEdge
+{
+    int from;                               // smaller endpoint
+    int to;                                 // larger endpoint
+    long long weight;                       // number of motif instances
+};
+
+class MotifAdjacency
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a motif adjacency computation over graph
+    // Preconditions: motif is the canonical mask of a connected size-k graph
+    // Postconditions: No weights are computed yet
+    MotifAdjacency(const Graph &graph, const int &k, const uint64_t &motif);
+
+
+    //--------------------------------- compute --------------------------------
+    // Computes the weight of every edge of the graph
+    // Preconditions: threads >= 1
+    // Postconditions: getEdges() holds every edge with a non-zero weight,
+    //                 sorted by (from, to)
+    void compute(const int &threads);
+
+
+    //-------------------------------- getEdges --------------------------------
+    // Weighted edges found by the last compute
+    // Preconditions: None
+    // Postconditions: Returns the weighted edge list
+    const vector<WeightedEdge> &getEdges() const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes the weighted edge list, one "from to weight" line per edge
+    // Preconditions: compute has been called
+    // Postconditions: The edge list is written to out
+    void write(ostream &out) const;
+
+
+private:
+    typedef unordered_map<uint64_t, long long> Accumulator;
+
+    // Per-thread visitor of the enumeration
+    struct Worker
+    {
+        Worker(const int &k, const uint64_t &motif, const int &n);
+
+        //--------------------------------- visit ------------------------------
+        // Adds one to every edge of a size-k instance of the motif
+        // Preconditions: mask is the packed adjacency of subgraph
+        // Postconditions: If the subgraph is the motif, its edges are credited
+        void visit(const int *subgraph, const int &k, const uint64_t &mask);
+
+        uint64_t motif;                     // canonical mask of the motif
+        Classifier classifier;              // per-thread class cache
+        Accumulator weights;                // sparse edge -> weight
+        EnumerationState state;             // enumeration buffers
+    };
+
+    const Graph &graph;                     // graph being analysed
+    int k;                                  // motif size
+    uint64_t motif;                         // canonical mask of the motif
+    vector<WeightedEdge> edges;             // result of compute
+
+
+    //------------------------ PRIVATE: countTriangles -------------------------
+    // Weight of (u, v) is the number of common neighbors of u and v
+    // Preconditions: The motif is the triangle
+    // Postconditions: The weights of all edges are in accumulators
+    void countTriangles(vector<Accumulator> &accumulators, const int &threads);
+
+    //------------------------- PRIVATE: countCliques4 -------------------------
+    // Weight of (u, v) is the number of edges among common neighbors of u, v
+    // Preconditions: The motif is the 4-clique
+    // Postconditions: The weights of all edges are in accumulators
+    void countCliques4(vector<Accumulator> &accumulators, const int &threads);
+
+    //------------------------- PRIVATE: countInstances ------------------------
+    // Enumerates every size-k subgraph and credits the edges of motif instances
+    // Preconditions: None
+    // Postconditions: The weights of all edges are in accumulators
+    void countInstances(vector<Accumulator> &accumulators, const int &threads);
+
+};
+
+#endif /* defined(__NemoSQL__MotifAdjacency__) */
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+//  MultiCensus.cpp
+//------------------------------------------------------------------------------
+// MultiCensus counts the connected subgraphs of every size from minimum to
+// maximum per isomorphism class in one enumeration.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a MultiCensus refers to it
+//   -- 2 <= minimum <= maximum <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "MultiCensus.h"
+
+#include <mutex>
+
+//------------------------------- Worker: Worker -------------------------------
+// Creates the buffers and class caches of one thread
+// Preconditions: 2 <= minimum <= maximum <= MAX_SUBGRAPH_SIZE
+// Postconditions: No subgraph is counted yet
+MultiCensus::Worker::Worker(const int &minimum, const int &maximum,
+                            const int &n)
+    : minimum(minimum), counts(maximum - minimum + 1)
+{
+    for (int k = minimum; k <= maximum; k++)
+        classifiers.emplace_back(k);
+    state.reset(maximum, n);
+}
+
+//-------------------------------- Worker: visit -------------------------------
+// Counts one subgraph under its adjacency mask
+// Preconditions: mask is the packed adjacency of subgraph, k its size
+// Postconditions: The count of mask among the size-k subgraphs is one more
+//                 if k >= minimum
+void MultiCensus::Worker::visit(const int *, const int &k,
+                                const uint64_t &mask)
+{
+    if (k < minimum)
+        return;
+
+    // Far fewer masks than subgraphs occur, so masks are counted here and
+    // classified once each when the counts are merged
+    counts[k - minimum][mask]++;
+}
+
+//------------------------------ Worker: visitRows -----------------------------
+// Counts the leaves under a prefix under their adjacency masks
+// Preconditions: mask is the packed adjacency of the k-1 vertices of prefix;
+//                counts[i] leaves add row rows[i] to it
+// Postconditions: The count of the mask of every row is counts[i] more
+void MultiCensus::Worker::visitRows(const int *, const int &k,
+                                    const uint64_t &mask, const uint32_t *rows,
+                                    const int *counts, const int &distinct)
+{
+    const int offset = (k - 1) * (k - 2) / 2;
+    unordered_map<uint64_t, long long> &leaves = this->counts[k - minimum];
+
+    for (int i = 0; i < distinct; i++)
+        leaves[mask | (uint64_t)rows[i] << offset] += counts[i];
+}
+
+//--------------------------------- Constructor --------------------------------
+// Creates a census of the subgraphs of graph of sizes minimum..maximum
+// Preconditions: 2 <= minimum <= maximum <= MAX_SUBGRAPH_SIZE
+// Postconditions: No subgraph is counted yet
+MultiCensus::MultiCensus(const Graph &graph, const int &minimum,
+                         const int &maximum)
+    : graph(graph), minimum(minimum), maximum(maximum),
+      counts(maximum - minimum + 1) {}
+
+//------------------------------------- run ------------------------------------
+// Counts every connected subgraph of the sizes by class
+// Preconditions: threads >= 1
+// Postconditions: getCounts(k) holds the census of size k for every k from
+//                 minimum to maximum
+void MultiCensus::run(const int &threads)
+{
+    vector<Worker *> workers(threads, nullptr);
+    mutex merge;
+    counts.assign(maximum - minimum + 1, ClassCounts());
+
+    parallelFor(0, graph.size(), threads, ROOT_CHUNK,
+                [&](int thread, int begin, int end)
+    {
+        if (workers[thread] == nullptr)
+            workers[thread] = new Worker(minimum, maximum, graph.size());
+        Worker &worker = *workers[thread];
+
+        for (int root = begin; root < end; root++)
+            graph.enumerateRoot<Worker, true>(root, maximum, worker,
+                                              worker.state);
+
+        // Masks are classified before the lock is taken, so the threads
+        // only wait on each other for adding the class totals
+        vector<ClassCounts> classes(counts.size());
+        for (size_t size = 0; size < counts.size(); size++)
+        {
+            Classifier &classifier = worker.classifiers[size];
+            for (const auto &entry : worker.counts[size])
+                classes[size][classifier.classify(entry.first)] +=
+                    entry.second;
+            worker.counts[size].clear();
+        }
+
+        lock_guard<mutex> lock(merge);
+        for (size_t size = 0; size < counts.size(); size++)
+            for (const auto &entry : classes[size])
+                counts[size][entry.first] += entry.second;
+    });
+
+    for (Worker *worker : workers)
+        delete worker;
+}
+
+//---------------------------------- getCounts ---------------------------------
+// Census of one size
+// Preconditions: minimum <= k <= maximum
+// Postconditions: Returns canonical mask -> number of instances
+const ClassCounts &MultiCensus::getCounts(const int &k) const
+{
+    return counts[k - minimum];
+}
+
+//---------------------------------- getTotal ----------------------------------
+// Number of subgraphs of one size
+// Preconditions: minimum <= k <= maximum
+// Postconditions: Returns the sum of getCounts(k)
+long long MultiCensus::getTotal(const int &k) const
+{
+    long long total = 0;
+    for (const auto &entry : counts[k - minimum])
+        total += entry.second;
+
+    return total;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes one "graph6 count" line per class, sizes ascending
+// Preconditions: None
+// Postconditions: Every census is written to out
+void MultiCensus::write(ostream &out) const
+{
+    for (int k = minimum; k <= maximum; k++)
+        for (const auto &entry : counts[k - minimum])
+            out << Classifier::toGraph6(entry.first, k) << "\t"
+                << entry.second << "\n";
+}
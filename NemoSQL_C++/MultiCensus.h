@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+//  MultiCensus.h
+//------------------------------------------------------------------------------
+// MultiCensus counts the connected subgraphs of every size from minimum to
+// maximum per isomorphism class in one enumeration, instead of one run per
+// size that walks the same search-tree prefixes again.
+//
+// Every node of the size-maximum search tree is a distinct connected subgraph
+// of its depth, so the enumeration is run for maximum with every node handed
+// to the visitor (Graph::enumerateRoot with EVERY_SIZE), and each is counted
+// in the census of its size. The inner nodes are few next to the leaves, so
+// the run costs little more than the census of maximum alone. Roots are
+// enumerated in parallel as in Census, each worker with one class cache and
+// one set of counts per size. Workers count raw adjacency masks, which are
+// far fewer than the subgraphs, and classify each one, outside the merge
+// lock, when a chunk of roots is done, so a subgraph costs one hash probe
+// instead of two.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a MultiCensus refers to it
+//   -- 2 <= minimum <= maximum <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__MultiCensus__
+#define __NemoSQL__MultiCensus__
+
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include "Checkpoint.h"
+#include "Classifier.h"
+#include "Enumeration.h"
+#include "Graph.h"
+#include "Parallel.h"
+
+using namespace std;
+
+class MultiCensus
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a census of the subgraphs of graph of sizes minimum..maximum
+    // Preconditions: 2 <= minimum <= maximum <= MAX_SUBGRAPH_SIZE
+    // Postconditions: No subgraph is counted yet
+    MultiCensus(const Graph &graph, const int &minimum, const int &maximum);
+
+
+    //----------------------------------- run ----------------------------------
+    // Counts every connected subgraph of the sizes by class
+    // Preconditions: threads >= 1
+    // Postconditions: getCounts(k) holds the census of size k for every k
+    //                 from minimum to maximum
+    void run(const int &threads = defaultThreads());
+
+
+    //-------------------------------- getCounts -------------------------------
+    // Census of one size
+    // Preconditions: minimum <= k <= maximum
+    // Postconditions: Returns canonical mask -> number of instances
+    const ClassCounts &getCounts(const int &k) const;
+
+
+    //-------------------------------- getTotal --------------------------------
+    // Number of subgraphs of one size
+    // Preconditions: minimum <= k <= maximum
+    // Postconditions: Returns the sum of getCounts(k)
+    long long getTotal(const int &k) const;
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes one "graph6 count" line per class, sizes ascending
+    // Preconditions: None
+    // Postconditions: Every census is written to out
+    void write(ostream &out) const;
+
+
+    // Per-thread visitor of the enumeration
+    struct Worker
+    {
+        Worker(const int &minimum, const int &maximum, const int &n);
+
+        //--------------------------------- visit ------------------------------
+        // Counts one subgraph under its adjacency mask
+        // Preconditions: mask is the packed adjacency of subgraph, k its size
+        // Postconditions: The count of mask among the size-k subgraphs is one
+        //                 more if k >= minimum
+        void visit(const int *subgraph, const int &k, const uint64_t &mask);
+
+        //------------------------------- visitRows ----------------------------
+        // Counts the leaves under a prefix under their adjacency masks
+        // Preconditions: mask is the packed adjacency of the k-1 vertices of
+        //                prefix; counts[i] leaves add row rows[i] to it
+        // Postconditions: The count of the mask of every row is counts[i]
+        //                 more
+        void visitRows(const int *prefix, const int &k, const uint64_t &mask,
+                       const uint32_t *rows, const int *counts,
+                       const int &distinct);
+
+        int minimum;                        // smallest size counted
+        vector<Classifier> classifiers;     // class cache, by size - minimum
+        vector<unordered_map<uint64_t, long long>> counts;  // by raw mask
+        EnumerationState state;             // enumeration buffers
+    };
+
+
+private:
+    const Graph &graph;                     // graph being counted
+    int minimum;                            // smallest size counted
+    int maximum;                            // largest size counted
+    vector<ClassCounts> counts;             // result of run, by size - minimum
+
+};
+
+#endif /* defined(__NemoSQL__MultiCensus__) */
@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+//  Parallel.h
+//------------------------------------------------------------------------------
+// Small helpers for spreading work over the roots of a Graph. Roots are handed
+// out in chunks from a shared atomic counter so that threads which get cheap
+// roots keep pulling work while others are still busy with hub vertices.
+//
+// ASSUMPTIONS:
+//   -- body(thread, begin, end) may be called many times per thread and must
+//      only touch state owned by that thread (or synchronize on its own)
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Parallel__
+#define __NemoSQL__Parallel__
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const int ROOT_CHUNK = 64;                  // roots handed out per grab
+
+//------------------------------- defaultThreads -------------------------------
+// Number of worker threads to use when the caller did not ask for a count
+// Preconditions: None
+// Postconditions: Returns the hardware concurrency, or 1 if it is unknown
+inline int defaultThreads()
+{
+    unsigned int n = thread::hardware_concurrency();
+    return n == 0 ? 1 : (int)n;
+}
+
+//--------------------------------- parallelFor --------------------------------
+// Runs body(thread, begin, end) over [first, last) in chunks of chunk items
+// Preconditions: threads >= 1, chunk >= 1
+// Postconditions: Every index in [first, last) has been passed to body exactly
+//                 once; thread is in [0, threads)
+template <class Body>
+void parallelFor(const int &first, const int &last, const int &threads,
+                 const int &chunk, Body body)
+{
+    atomic<int> next(first);
+
+    auto worker = [&](int thread)
+    {
+        for (;;)
+        {
+            int begin = next.fetch_add(chunk, memory_order_relaxed);
+            if (begin >= last)
+                return;
+
+            body(thread, begin, min(begin + chunk, last));
+        }
+    };
+
+    if (threads <= 1)
+    {
+        worker(0);
+        return;
+    }
+
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.push_back(thread(worker, t));
+
+    for (thread &t : pool)
+        t.join();
+}
+
+#endif /* defined(__NemoSQL__Parallel__) */
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+//  PerfCounters.cpp
+//------------------------------------------------------------------------------
+// PerfCounters reads the hardware performance counters of the process through
+// the Linux perf_event_open interface. Only user-space events are counted,
+// which most kernels allow unprivileged processes to do.
+//
+// ASSUMPTIONS:
+//   -- start and stop are called by the thread that constructed the object
+//
+//------------------------------------------------------------------------------
+
+#include "PerfCounters.h"
+
+#include <cstdint>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+//---------------------------------- openEvent ---------------------------------
+// Opens one user-space counter of this process and the threads it creates
+// Preconditions: None
+// Postconditions: Returns the stopped counter's descriptor, or -1 if refused
+static int openEvent(const uint32_t &type, const uint64_t &config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+//--------------------------------- Constructor --------------------------------
+// Opens every counter the system allows
+// Preconditions: None
+// Postconditions: The opened counters are stopped and zero
+PerfCounters::PerfCounters()
+{
+    for (int c = 0; c < COUNTERS; c++)
+    {
+        descriptors[c] = -1;
+        counts[c] = -1;
+    }
+
+#ifdef __linux__
+    const uint64_t readMiss = PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                              PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+
+    descriptors[CYCLES] = openEvent(PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_CPU_CYCLES);
+    descriptors[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE,
+                                          PERF_COUNT_HW_INSTRUCTIONS);
+    descriptors[L1D_MISSES] = openEvent(PERF_TYPE_HW_CACHE,
+                                        PERF_COUNT_HW_CACHE_L1D | readMiss);
+    descriptors[LLC_MISSES] = openEvent(PERF_TYPE_HARDWARE,
+                                        PERF_COUNT_HW_CACHE_MISSES);
+    descriptors[BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE,
+                                           PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+//---------------------------------- Destructor --------------------------------
+// Closes the counters
+// Preconditions: None
+// Postconditions: None
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTERS; c++)
+        if (descriptors[c] >= 0)
+            close(descriptors[c]);
+#endif
+}
+
+//---------------------------------- available ---------------------------------
+// Whether any counter could be opened
+// Preconditions: None
+// Postconditions: Returns false if every counter reads as -1
+bool PerfCounters::available() const
+{
+    for (int c = 0; c < COUNTERS; c++)
+        if (descriptors[c] >= 0)
+            return true;
+
+    return false;
+}
+
+//------------------------------------ start -----------------------------------
+// Starts counting from zero
+// Preconditions: None
+// Postconditions: The opened counters are reset and running
+void PerfCounters::start()
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTERS; c++)
+        if (descriptors[c] >= 0)
+        {
+            ioctl(descriptors[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptors[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+}
+
+//------------------------------------- stop -----------------------------------
+// Stops counting
+// Preconditions: start was called
+// Postconditions: get() returns the counts since start
+void PerfCounters::stop()
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTERS; c++)
+        if (descriptors[c] >= 0)
+            ioctl(descriptors[c], PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int c = 0; c < COUNTERS; c++)
+    {
+        counts[c] = -1;
+
+        // value, time enabled, time running
+        uint64_t values[3];
+        if (descriptors[c] < 0 ||
+            read(descriptors[c], values, sizeof(values)) != sizeof(values))
+            continue;
+
+        // When more counters are open than the PMU has, the kernel rotates
+        // them; scale up by the share of time this one was on the PMU
+        if (values[2] == 0)
+            counts[c] = values[1] == 0 ? 0 : -1;
+        else
+            counts[c] = (long long)((double)values[0] * values[1] / values[2]);
+    }
+#endif
+}
+
+//------------------------------------- get ------------------------------------
+// Count of one counter between the last start and stop
+// Preconditions: None
+// Postconditions: Returns the count, scaled up if the kernel multiplexed
+//                 the counter, or -1 if the counter is unavailable
+long long PerfCounters::get(const Counter &counter) const
+{
+    return counts[counter];
+}
+
+//------------------------------------- name -----------------------------------
+// Name of a counter, as used in benchmark output
+// Preconditions: counter < COUNTERS
+// Postconditions: Returns e.g. "cycles" or "llc_misses"
+string PerfCounters::name(const Counter &counter)
+{
+    static const char *names[COUNTERS] =
+    {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+    };
+
+    return names[counter];
+}
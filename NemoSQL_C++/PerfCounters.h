@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+//  PerfCounters.h
+//------------------------------------------------------------------------------
+// PerfCounters reads the hardware performance counters of the process through
+// the Linux perf_event_open interface: cycles, instructions, L1 data cache
+// read misses, last-level cache misses and branch misses. Each counter is
+// opened on its own so that a machine (or container, or paranoid kernel
+// setting) which refuses some of them still reports the rest; counters that
+// could not be opened read as -1. Counters follow the threads the process
+// creates after they were opened, so a parallel phase is counted in full.
+//
+// ASSUMPTIONS:
+//   -- start and stop are called by the thread that constructed the object
+//   -- on other systems than Linux every counter is unavailable
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__PerfCounters__
+#define __NemoSQL__PerfCounters__
+
+#include <string>
+
+using namespace std;
+
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, COUNTERS
+    };
+
+
+    //------------------------------- Constructor ------------------------------
+    // Opens every counter the system allows
+    // Preconditions: None
+    // Postconditions: The opened counters are stopped and zero
+    PerfCounters();
+
+
+    //------------------------------- Destructor -------------------------------
+    // Closes the counters
+    // Preconditions: None
+    // Postconditions: None
+    ~PerfCounters();
+
+
+    //-------------------------------- available -------------------------------
+    // Whether any counter could be opened
+    // Preconditions: None
+    // Postconditions: Returns false if every counter reads as -1
+    bool available() const;
+
+
+    //---------------------------------- start ---------------------------------
+    // Starts counting from zero
+    // Preconditions: None
+    // Postconditions: The opened counters are reset and running
+    void start();
+
+
+    //---------------------------------- stop ----------------------------------
+    // Stops counting
+    // Preconditions: start was called
+    // Postconditions: get() returns the counts since start
+    void stop();
+
+
+    //----------------------------------- get ----------------------------------
+    // Count of one counter between the last start and stop
+    // Preconditions: None
+    // Postconditions: Returns the count, scaled up if the kernel multiplexed
+    //                 the counter, or -1 if the counter is unavailable
+    long long get(const Counter &counter) const;
+
+
+    //----------------------------------- name ---------------------------------
+    // Name of a counter, as used in benchmark output
+    // Preconditions: counter < COUNTERS
+    // Postconditions: Returns e.g. "cycles" or "llc_misses"
+    static string name(const Counter &counter);
+
+
+private:
+    int descriptors[COUNTERS];              // perf event fds, -1 if refused
+    long long counts[COUNTERS];             // counts of the last start/stop
+
+};
+
+#endif /* defined(__NemoSQL__PerfCounters__) */
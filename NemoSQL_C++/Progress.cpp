@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//  Progress.cpp
+//------------------------------------------------------------------------------
+// Progress reports on a running enumeration from a background thread, every
+// few seconds and whenever the process receives SIGUSR1.
+//
+// ASSUMPTIONS:
+//   -- only one Progress is active at a time, since SIGUSR1 is process-wide
+//
+//------------------------------------------------------------------------------
+
+#include "Progress.h"
+
+#include <algorithm>
+
+const int POLL_MILLISECONDS = 100;          // how often SIGUSR1 is noticed
+
+static volatile sig_atomic_t snapshotRequested = 0;
+
+//------------------------------- requestSnapshot ------------------------------
+// SIGUSR1 handler; only sets a flag, which is all a handler may safely do
+// Preconditions: None
+// Postconditions: The reporter prints a snapshot on its next poll
+extern "C" void requestSnapshot(int)
+{
+    snapshotRequested = 1;
+}
+
+//--------------------------------- Constructor --------------------------------
+// Starts reporting on an enumeration of roots roots
+// Preconditions: None
+// Postconditions: A line is printed to cerr every intervalSeconds (never if
+//                 intervalSeconds <= 0) and on SIGUSR1, followed by
+//                 snapshot(cerr) on SIGUSR1. The ETA uses expectedLeaves
+//                 when it is positive and the fraction of roots otherwise
+Progress::Progress(const int &roots, const double &expectedLeaves,
+                   const int &intervalSeconds,
+                   const function<void(ostream &)> &snapshot)
+    : roots(roots), expectedLeaves(expectedLeaves),
+      intervalSeconds(intervalSeconds), snapshot(snapshot),
+      start(Clock::now()), rootsDone(0), leavesDone(0)
+{
+    snapshotRequested = 0;
+    previous = signal(SIGUSR1, requestSnapshot);
+    reporter = thread(&Progress::loop, this);
+}
+
+//--------------------------------- Destructor ---------------------------------
+// Stops reporting
+// Preconditions: None
+// Postconditions: The reporter thread is joined; SIGUSR1 is restored
+Progress::~Progress()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    reporter.join();
+
+    signal(SIGUSR1, previous == SIG_ERR ? SIG_DFL : previous);
+}
+
+//------------------------------------- add ------------------------------------
+// Records finished work
+// Preconditions: None
+// Postconditions: roots roots and leaves subgraphs are added to the totals
+void Progress::add(const int &roots, const long long &leaves)
+{
+    rootsDone.fetch_add(roots, memory_order_relaxed);
+    leavesDone.fetch_add(leaves, memory_order_relaxed);
+}
+
+//------------------------------------ report ----------------------------------
+// Writes the progress line
+// Preconditions: None
+// Postconditions: Roots done, rate and ETA are written to out
+void Progress::report(ostream &out) const
+{
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+    long long done = rootsDone.load(memory_order_relaxed);
+    long long leaves = leavesDone.load(memory_order_relaxed);
+    double rate = elapsed > 0 ? leaves / elapsed : 0;
+
+    double eta = -1;
+    if (expectedLeaves > 0 && rate > 0)
+        eta = max(0.0, expectedLeaves - leaves) / rate;
+    else if (done > 0)
+        eta = elapsed * (roots - done) / done;
+
+    out << "Progress: " << done << "/" << roots << " roots, " << leaves
+        << " subgraphs, " << (long long)rate << " subgraphs/s, ETA ";
+    if (eta < 0)
+        out << "unknown";
+    else
+        out << (long long)eta << " s";
+    out << endl;
+}
+
+//-------------------------------- PRIVATE: loop -------------------------------
+// Prints on every interval and every SIGUSR1 until stopped
+// Preconditions: None
+// Postconditions: Returns once the destructor asks it to
+void Progress::loop()
+{
+    Clock::time_point next = Clock::now() + chrono::seconds(intervalSeconds);
+    unique_lock<mutex> guard(lock);
+
+    while (!wake.wait_for(guard, chrono::milliseconds(POLL_MILLISECONDS),
+                          [this] { return stopping; }))
+    {
+        if (snapshotRequested)
+        {
+            snapshotRequested = 0;
+            report(cerr);
+            if (snapshot)
+                snapshot(cerr);
+        }
+
+        if (intervalSeconds > 0 && Clock::now() >= next)
+        {
+            report(cerr);
+            next += chrono::seconds(intervalSeconds);
+        }
+    }
+}
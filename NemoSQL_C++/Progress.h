@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+//  Progress.h
+//------------------------------------------------------------------------------
+// Progress reports on a running enumeration from a background thread. The
+// workers only add to two relaxed atomic counters once per chunk of roots;
+// the reporter thread turns them into roots done, subgraphs per second and an
+// ETA, printed every few seconds. Sending SIGUSR1 to the process makes the
+// reporter print the same line plus a caller-supplied snapshot (e.g. the
+// partial census) while the workers keep running.
+//
+// ASSUMPTIONS:
+//   -- only one Progress is active at a time, since SIGUSR1 is process-wide
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Progress__
+#define __NemoSQL__Progress__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+class Progress
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Starts reporting on an enumeration of roots roots
+    // Preconditions: None
+    // Postconditions: A line is printed to cerr every intervalSeconds (never if
+    //                 intervalSeconds <= 0) and on SIGUSR1, followed by
+    //                 snapshot(cerr) on SIGUSR1. The ETA uses expectedLeaves
+    //                 when it is positive and the fraction of roots otherwise
+    Progress(const int &roots, const double &expectedLeaves,
+             const int &intervalSeconds,
+             const function<void(ostream &)> &snapshot);
+
+
+    //------------------------------- Destructor -------------------------------
+    // Stops reporting
+    // Preconditions: None
+    // Postconditions: The reporter thread is joined; SIGUSR1 is restored
+    ~Progress();
+
+
+    //----------------------------------- add ----------------------------------
+    // Records finished work
+    // Preconditions: None
+    // Postconditions: roots roots and leaves subgraphs are added to the totals
+    void add(const int &roots, const long long &leaves);
+
+
+    //---------------------------------- report --------------------------------
+    // Writes the progress line
+    // Preconditions: None
+    // Postconditions: Roots done, rate and ETA are written to out
+    void report(ostream &out) const;
+
+
+private:
+    typedef chrono::steady_clock Clock;
+
+    int roots;                              // roots in the enumeration
+    double expectedLeaves;                  // predicted subgraphs, 0 if unknown
+    int intervalSeconds;                    // seconds between reports
+    function<void(ostream &)> snapshot;     // extra output on SIGUSR1
+    Clock::time_point start;                // when the enumeration started
+
+    atomic<long long> rootsDone;            // finished roots
+    atomic<long long> leavesDone;           // subgraphs found so far
+
+    mutex lock;                             // guards stopping
+    condition_variable wake;                // signalled to stop
+    bool stopping = false;                  // set by the destructor
+    void (*previous)(int);                  // SIGUSR1 handler before us
+    thread reporter;                        // runs loop()
+
+
+    //------------------------------ PRIVATE: loop -----------------------------
+    // Prints on every interval and every SIGUSR1 until stopped
+    // Preconditions: None
+    // Postconditions: Returns once the destructor asks it to
+    void loop();
+
+};
+
+#endif /* defined(__NemoSQL__Progress__) */
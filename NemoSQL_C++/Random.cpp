@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+//  Random.cpp
+//------------------------------------------------------------------------------
+// Random is the xoshiro256** generator of every randomized path in the tree,
+// with jump-ahead streams for parallel work.
+//
+// ASSUMPTIONS:
+//   -- a Random object is used by one thread at a time
+//
+//------------------------------------------------------------------------------
+
+#include "Random.h"
+
+//--------------------------------- Constructor --------------------------------
+// Creates the master generator of seed
+// Preconditions: None
+// Postconditions: The state is filled from seed by splitmix64, so that
+//                 nearby seeds give unrelated sequences
+Random::Random(const uint64_t &seed)
+{
+    uint64_t x = seed;
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+//------------------------------------ jump ------------------------------------
+// Skips ahead
+// Preconditions: None
+// Postconditions: The state is advanced by 2^128 draws
+void Random::jump()
+{
+    // Polynomial of the 2^128-th power of the transition, from the reference
+    // implementation of xoshiro256**
+    static const uint64_t JUMP[4] =
+    {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+    };
+
+    uint64_t jumped[4] = {0, 0, 0, 0};
+    for (int word = 0; word < 4; word++)
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (JUMP[word] >> bit & 1)
+                for (int i = 0; i < 4; i++)
+                    jumped[i] ^= state[i];
+            next();
+        }
+
+    for (int i = 0; i < 4; i++)
+        state[i] = jumped[i];
+}
+
+//------------------------------------ stream ----------------------------------
+// Generator of work item index under a master seed
+// Preconditions: None
+// Postconditions: Returns Random(seed) jumped index times
+Random Random::stream(const uint64_t &seed, const uint64_t &index)
+{
+    Random random(seed);
+
+    for (uint64_t i = 0; i < index; i++)
+        random.jump();
+
+    return random;
+}
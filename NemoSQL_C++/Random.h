@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//  Random.h
+//------------------------------------------------------------------------------
+// Random is the pseudo-random generator of every randomized path in the tree
+// (edge switching, random graph generation, search-tree estimation). It is
+// xoshiro256**: 256 bits of state, a period of 2^256 - 1, and a jump function
+// that advances the state by 2^128 draws in a few hundred operations.
+//
+// Parallel work must not share one generator, and giving each thread its own
+// generator seeded from the thread number makes results depend on the thread
+// count. Instead, work item i (a random graph, a chain, ...) draws from
+// stream(seed, i): the master seed's generator jumped i times. Streams never
+// overlap in practice, and a given seed yields the same numbers for item i
+// whichever thread runs it.
+//
+// ASSUMPTIONS:
+//   -- a Random object is used by one thread at a time
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Random__
+#define __NemoSQL__Random__
+
+#include <cstdint>
+
+using namespace std;
+
+class Random
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates the master generator of seed
+    // Preconditions: None
+    // Postconditions: The state is filled from seed by splitmix64, so that
+    //                 nearby seeds give unrelated sequences
+    Random(const uint64_t &seed = 1);
+
+
+    //------------------------------------ next --------------------------------
+    // Next 64 random bits
+    // Preconditions: None
+    // Postconditions: The state is advanced by one draw
+    uint64_t next()
+    {
+        const uint64_t result = rotate(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate(state[3], 45);
+
+        return result;
+    }
+
+
+    //---------------------------------- uniform -------------------------------
+    // Random integer in [0, n)
+    // Preconditions: n >= 1
+    // Postconditions: Returns a uniform integer below n (multiply-shift; the
+    //                 bias is below n / 2^64)
+    uint64_t uniform(const uint64_t &n)
+    {
+        return (uint64_t)((unsigned __int128)next() * n >> 64);
+    }
+
+
+    //-------------------------------- probability -----------------------------
+    // Random real number in [0, 1)
+    // Preconditions: None
+    // Postconditions: Returns a uniform double with 53 random bits
+    double probability()
+    {
+        return (next() >> 11) * 0x1.0p-53;
+    }
+
+
+    //------------------------------------ jump --------------------------------
+    // Skips ahead
+    // Preconditions: None
+    // Postconditions: The state is advanced by 2^128 draws
+    void jump();
+
+
+    //----------------------------------- stream -------------------------------
+    // Generator of work item index under a master seed
+    // Preconditions: None
+    // Postconditions: Returns Random(seed) jumped index times
+    static Random stream(const uint64_t &seed, const uint64_t &index);
+
+
+private:
+    uint64_t state[4];                      // xoshiro256 state, not all zero
+
+
+    //----------------------------- PRIVATE: rotate ----------------------------
+    // Rotates x left by bits
+    // Preconditions: 0 < bits < 64
+    // Postconditions: Returns the rotated value
+    static uint64_t rotate(const uint64_t &x, const int &bits)
+    {
+        return x << bits | x >> (64 - bits);
+    }
+
+};
+
+#endif /* defined(__NemoSQL__Random__) */
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+//  Randomizer.cpp
+//------------------------------------------------------------------------------
+// Randomizer produces random graphs with the same degree sequence as a given
+// Graph by edge switching on a flat array of packed edges.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a Randomizer refers to it
+//
+//------------------------------------------------------------------------------
+
+#include "Randomizer.h"
+
+#include <cmath>
+
+const int ATTEMPTS_PER_SWAP = 100;          // give up after this many per switch
+
+//--------------------------------- Constructor --------------------------------
+// Creates a randomizer starting from the edges of graph
+// Preconditions: None
+// Postconditions: getEdges() holds the edges of graph; switches are drawn
+//                 from a generator seeded by seed
+Randomizer::Randomizer(const Graph &graph, const uint64_t &seed)
+    : vertices(graph.size()), random(seed)
+{
+    for (int u = 0; u < graph.size(); u++)
+        for (int v : graph.neighbors(u))
+            if (u < v)
+                original.push_back(edgeKey(u, v));
+
+    reset();
+}
+
+//---------------------------------- randomize ---------------------------------
+// Switches edges, continuing from the current edges
+// Preconditions: swapsPerEdge >= 0
+// Postconditions: swapsPerEdge * (number of edges) switches were made, or
+//                 fewer if the graph allows too few (at most 100 attempts
+//                 per switch); returns the number made
+long long Randomizer::randomize(const double &swapsPerEdge)
+{
+    removed.clear();
+    added.clear();
+
+    if (edges.size() < 2)
+        return 0;
+
+    const long long wanted = llround(swapsPerEdge * edges.size());
+    const long long attempts = wanted * ATTEMPTS_PER_SWAP;
+
+    long long made = 0;
+    for (long long a = 0; a < attempts && made < wanted; a++)
+        if (swap())
+            made++;
+
+    return made;
+}
+
+//---------------------------------- setRandom ---------------------------------
+// Replaces the source of the random switches
+// Preconditions: None
+// Postconditions: Switches are drawn from a copy of random, e.g. a stream
+//                 of Random::stream
+void Randomizer::setRandom(const Random &random)
+{
+    this->random = random;
+}
+
+//------------------------------------ record ----------------------------------
+// Turns the log of switched edges on or off
+// Preconditions: None
+// Postconditions: While on, each randomize call logs the edges it removes
+//                 and adds in getRemoved() and getAdded()
+void Randomizer::record(const bool &on)
+{
+    recording = on;
+}
+
+//---------------------------------- getRemoved --------------------------------
+// Edges removed by the last randomize call while recording
+// Preconditions: None
+// Postconditions: Returns the packed edges in switch order; an edge that
+//                 came and went several times appears as often
+const vector<uint64_t> &Randomizer::getRemoved() const
+{
+    return removed;
+}
+
+//----------------------------------- getAdded ---------------------------------
+// Edges added by the last randomize call while recording
+// Preconditions: None
+// Postconditions: Returns the packed edges in switch order
+const vector<uint64_t> &Randomizer::getAdded() const
+{
+    return added;
+}
+
+//------------------------------------ reset -----------------------------------
+// Goes back to the edges of the original graph
+// Preconditions: None
+// Postconditions: getEdges() holds the edges the randomizer started from
+void Randomizer::reset()
+{
+    edges = original;
+
+    edgeSet = EdgeSet(edges.size());
+    for (uint64_t edge : edges)
+        edgeSet.insert(edge);
+}
+
+//---------------------------------- getEdges ----------------------------------
+// Current edges
+// Preconditions: None
+// Postconditions: Returns the packed edges in no particular order
+const vector<uint64_t> &Randomizer::getEdges() const
+{
+    return edges;
+}
+
+//--------------------------------- buildGraph ---------------------------------
+// Loads the current edges into a graph
+// Preconditions: None
+// Postconditions: graph holds the current edges and as many vertex slots
+//                 as the original graph
+void Randomizer::buildGraph(Graph &graph) const
+{
+    graph.buildGraph(edges, vertices);
+}
+
+//------------------------------- PRIVATE: swap --------------------------------
+// Attempts one edge switch
+// Preconditions: There are at least two edges
+// Postconditions: Returns true if two edges were switched
+bool Randomizer::swap()
+{
+    size_t i = random.uniform(edges.size());
+    size_t j = random.uniform(edges.size());
+    if (i == j)
+        return false;
+
+    // Picking the orientation of the second edge at random chooses between
+    // the two ways of rewiring the pair
+    uint64_t bits = random.next();
+    uint64_t a = edges[i] >> 32, b = edges[i] & 0xffffffff;
+    uint64_t c = edges[j] >> 32, d = edges[j] & 0xffffffff;
+    if (bits & 1)
+        std::swap(c, d);
+
+    if (a == d || c == b)
+        return false;
+
+    uint64_t first = edgeKey(a, d), second = edgeKey(c, b);
+    if (edgeSet.contains(first) || edgeSet.contains(second))
+        return false;
+
+    edgeSet.erase(edges[i]);
+    edgeSet.erase(edges[j]);
+    edgeSet.insert(first);
+    edgeSet.insert(second);
+
+    if (recording)
+    {
+        removed.push_back(edges[i]);
+        removed.push_back(edges[j]);
+        added.push_back(first);
+        added.push_back(second);
+    }
+
+    edges[i] = first;
+    edges[j] = second;
+    return true;
+}
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+//  Randomizer.h
+//------------------------------------------------------------------------------
+// Randomizer produces random graphs with the same degree sequence as a given
+// Graph by edge switching: two edges (a, b) and (c, d) are picked at random
+// and replaced by (a, d) and (c, b), or by (a, c) and (b, d), unless that
+// would create a loop or an edge that already exists. Each switch keeps every
+// degree, and after a few switches per edge the result is a uniform sample of
+// the graphs with that degree sequence.
+//
+// The edges live in one flat array of packed keys, so picking an edge is one
+// random index, and duplicates are rejected through an EdgeSet in O(1). The
+// randomized edges can be loaded into a Graph with buildGraph, ready for a
+// Census, without going through a file.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a Randomizer refers to it
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Randomizer__
+#define __NemoSQL__Randomizer__
+
+#include <cstdint>
+#include <vector>
+#include "EdgeSet.h"
+#include "Graph.h"
+#include "Random.h"
+
+using namespace std;
+
+class Randomizer
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a randomizer starting from the edges of graph
+    // Preconditions: None
+    // Postconditions: getEdges() holds the edges of graph; switches are drawn
+    //                 from a generator seeded by seed
+    Randomizer(const Graph &graph, const uint64_t &seed = 1);
+
+
+    //-------------------------------- randomize -------------------------------
+    // Switches edges, continuing from the current edges
+    // Preconditions: swapsPerEdge >= 0
+    // Postconditions: swapsPerEdge * (number of edges) switches were made, or
+    //                 fewer if the graph allows too few (at most 100 attempts
+    //                 per switch); returns the number made
+    long long randomize(const double &swapsPerEdge);
+
+
+    //-------------------------------- setRandom -------------------------------
+    // Replaces the source of the random switches
+    // Preconditions: None
+    // Postconditions: Switches are drawn from a copy of random, e.g. a stream
+    //                 of Random::stream
+    void setRandom(const Random &random);
+
+
+    //---------------------------------- record --------------------------------
+    // Turns the log of switched edges on or off
+    // Preconditions: None
+    // Postconditions: While on, each randomize call logs the edges it removes
+    //                 and adds in getRemoved() and getAdded()
+    void record(const bool &on);
+
+
+    //-------------------------------- getRemoved ------------------------------
+    // Edges removed by the last randomize call while recording
+    // Preconditions: None
+    // Postconditions: Returns the packed edges in switch order; an edge that
+    //                 came and went several times appears as often
+    const vector<uint64_t> &getRemoved() const;
+
+
+    //--------------------------------- getAdded -------------------------------
+    // Edges added by the last randomize call while recording
+    // Preconditions: None
+    // Postconditions: Returns the packed edges in switch order
+    const vector<uint64_t> &getAdded() const;
+
+
+    //---------------------------------- reset ---------------------------------
+    // Goes back to the edges of the original graph
+    // Preconditions: None
+    // Postconditions: getEdges() holds the edges the randomizer started from
+    void reset();
+
+
+    //-------------------------------- getEdges --------------------------------
+    // Current edges
+    // Preconditions: None
+    // Postconditions: Returns the packed edges in no particular order
+    const vector<uint64_t> &getEdges() const;
+
+
+    //------------------------------- buildGraph -------------------------------
+    // Loads the current edges into a graph
+    // Preconditions: None
+    // Postconditions: graph holds the current edges and as many vertex slots
+    //                 as the original graph
+    void buildGraph(Graph &graph) const;
+
+
+private:
+    int vertices;                           // vertex slots of the original
+    vector<uint64_t> original;              // edges of the original graph
+    vector<uint64_t> edges;                 // current edges
+    EdgeSet edgeSet;                        // current edges, for lookups
+    Random random;                          // source of the switches
+    bool recording = false;                 // whether switches are logged
+    vector<uint64_t> removed;               // logged removed edges
+    vector<uint64_t> added;                 // logged added edges
+
+
+    //----------------------------- PRIVATE: swap ------------------------------
+    // Attempts one edge switch
+    // Preconditions: There are at least two edges
+    // Postconditions: Returns true if two edges were switched
+    bool swap();
+
+};
+
+#endif /* defined(__NemoSQL__Randomizer__) */
@@ -0,0 +1,407 @@
+//------------------------------------------------------------------------------
+//  SqliteExtension.cpp
+//------------------------------------------------------------------------------
+// SqliteExtension is an SQLite loadable extension that runs the motif engine
+// inside SQL, over an edges table of the same database:
+//
+//   SELECT * FROM esu('edges', 4);
+//       one row (vertices, class, graph6) per connected 4-vertex subgraph;
+//       vertices is the ascending vertex IDs separated by spaces, class the
+//       canonical adjacency mask and graph6 its graph6 string
+//   SELECT * FROM motif_census('edges', 4);
+//       one row (class, graph6, count) per class
+//
+// Both are eponymous virtual tables whose hidden columns edges_table and k are
+// the arguments. The first two columns of every row of the edges table are an
+// undirected edge between non-negative integer vertex IDs; other columns,
+// repeated edges and self loops are ignored. esu streams its rows from a
+// SubgraphGenerator, so LIMIT and early-ending joins stop the enumeration;
+// motif_census runs a parallel Census when the query starts.
+//
+// Build (one command) and load:
+//   g++ -O2 -std=c++17 -pthread -shared -fPIC -o nemosql.so
+//       SqliteExtension.cpp Census.cpp Checkpoint.cpp Classifier.cpp
+//       Graph.cpp Progress.cpp Stats.cpp SubgraphGenerator.cpp
+//   sqlite> .load ./nemosql
+//
+// ASSUMPTIONS:
+//   -- the edges table is not written while a query over it runs
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE (other values are an SQL error)
+//
+//------------------------------------------------------------------------------
+
+#include <sqlite3ext.h>
+SQLITE_EXTENSION_INIT1
+
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Census.h"
+#include "Classifier.h"
+#include "EdgeSet.h"
+#include "Graph.h"
+#include "SubgraphGenerator.h"
+
+using namespace std;
+
+// Columns shared by both tables, after their visible ones
+static const int EDGES_TABLE = 3;           // hidden: name of the edges table
+static const int SUBGRAPH_SIZE = 4;         // hidden: k
+
+//------------------------------------------------------------------------------
+// One esu or motif_census table of a connection
+struct MotifTable
+{
+    sqlite3_vtab base;                      // must come first
+    sqlite3 *db;                            // connection that holds the edges
+    bool census;                            // motif_census rather than esu
+};
+
+//------------------------------------------------------------------------------
+// One running query
+struct MotifCursor
+{
+    sqlite3_vtab_cursor base;               // must come first
+    string edges;                           // edges table of the query
+    int k = 0;                              // subgraph size of the query
+    Graph graph;                            // read from the edges table
+    SubgraphGenerator *instances = nullptr; // esu: walk over the graph
+    Classifier *classifier = nullptr;       // esu: class of each instance
+    vector<pair<uint64_t, long long>> counts;   // motif_census: its rows
+    size_t position = 0;                    // motif_census: current row
+    sqlite3_int64 rowid = 0;                // rows produced so far
+    bool eof = true;                        // no current row
+
+    ~MotifCursor()
+    {
+        delete instances;
+        delete classifier;
+    }
+};
+
+//---------------------------------- loadEdges ---------------------------------
+// Builds graph from the first two columns of table
+// Preconditions: None
+// Postconditions: Returns SQLITE_OK, or an error code with message set to an
+//                 sqlite3_mprintf string
+static int loadEdges(sqlite3 *db, const char *table, Graph &graph,
+                     char *&message)
+{
+    char *sql = sqlite3_mprintf("SELECT * FROM \"%w\"", table);
+    sqlite3_stmt *rows = nullptr;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &rows, nullptr);
+    sqlite3_free(sql);
+    if (rc != SQLITE_OK)
+    {
+        message = sqlite3_mprintf("%s", sqlite3_errmsg(db));
+        return rc;
+    }
+
+    if (sqlite3_column_count(rows) < 2)
+    {
+        sqlite3_finalize(rows);
+        message = sqlite3_mprintf("%s needs two vertex columns", table);
+        return SQLITE_ERROR;
+    }
+
+    vector<uint64_t> edges;
+    int n = 0;
+    while ((rc = sqlite3_step(rows)) == SQLITE_ROW)
+    {
+        sqlite3_int64 u = sqlite3_column_int64(rows, 0);
+        sqlite3_int64 v = sqlite3_column_int64(rows, 1);
+        if (u < 0 || v < 0 || u >= INT_MAX || v >= INT_MAX)
+        {
+            sqlite3_finalize(rows);
+            message = sqlite3_mprintf("vertex IDs of %s must be in [0, %d)",
+                                      table, INT_MAX);
+            return SQLITE_ERROR;
+        }
+
+        if (u != v)
+        {
+            edges.push_back(edgeKey((int)u, (int)v));
+            n = max(n, (int)max(u, v) + 1);
+        }
+    }
+
+    if (rc != SQLITE_DONE)
+        message = sqlite3_mprintf("%s", sqlite3_errmsg(db));
+    sqlite3_finalize(rows);
+    if (rc != SQLITE_DONE)
+        return rc;
+
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+    graph.buildGraph(edges, n);
+    return SQLITE_OK;
+}
+
+//----------------------------------- connect ----------------------------------
+// xConnect: declares the columns of esu or motif_census
+static int motifConnect(sqlite3 *db, void *aux, int, const char *const *,
+                        sqlite3_vtab **table, char **)
+{
+    const bool census = aux != nullptr;
+    int rc = sqlite3_declare_vtab(db, census
+        ? "CREATE TABLE x(class INTEGER, graph6 TEXT, count INTEGER, "
+          "edges_table HIDDEN, k HIDDEN)"
+        : "CREATE TABLE x(vertices TEXT, class INTEGER, graph6 TEXT, "
+          "edges_table HIDDEN, k HIDDEN)");
+    if (rc != SQLITE_OK)
+        return rc;
+
+    MotifTable *created = new MotifTable();
+    created->db = db;
+    created->census = census;
+    *table = &created->base;
+    return SQLITE_OK;
+}
+
+//--------------------------------- disconnect ---------------------------------
+// xDisconnect
+static int motifDisconnect(sqlite3_vtab *table)
+{
+    delete (MotifTable *)table;
+    return SQLITE_OK;
+}
+
+//---------------------------------- bestIndex ---------------------------------
+// xBestIndex: both arguments must be given as equality constraints
+static int motifBestIndex(sqlite3_vtab *, sqlite3_index_info *info)
+{
+    int found[2] = {-1, -1};
+
+    for (int i = 0; i < info->nConstraint; i++)
+    {
+        const auto &constraint = info->aConstraint[i];
+        if (constraint.op != SQLITE_INDEX_CONSTRAINT_EQ)
+            continue;
+
+        if (constraint.iColumn == EDGES_TABLE ||
+            constraint.iColumn == SUBGRAPH_SIZE)
+        {
+            // An unusable constraint makes this plan impossible, not the query
+            if (!constraint.usable)
+                return SQLITE_CONSTRAINT;
+            found[constraint.iColumn - EDGES_TABLE] = i;
+        }
+    }
+
+    if (found[0] < 0 || found[1] < 0)
+        return SQLITE_CONSTRAINT;
+
+    for (int argument = 0; argument < 2; argument++)
+    {
+        info->aConstraintUsage[found[argument]].argvIndex = argument + 1;
+        info->aConstraintUsage[found[argument]].omit = 1;
+    }
+    info->estimatedCost = 1e6;
+    return SQLITE_OK;
+}
+
+//------------------------------------ open ------------------------------------
+// xOpen
+static int motifOpen(sqlite3_vtab *, sqlite3_vtab_cursor **cursor)
+{
+    *cursor = &(new MotifCursor())->base;
+    return SQLITE_OK;
+}
+
+//------------------------------------ close -----------------------------------
+// xClose
+static int motifClose(sqlite3_vtab_cursor *cursor)
+{
+    delete (MotifCursor *)cursor;
+    return SQLITE_OK;
+}
+
+//------------------------------------ filter ----------------------------------
+// xFilter: reads the edges and starts the enumeration or the census
+static int motifFilter(sqlite3_vtab_cursor *base, int, const char *, int argc,
+                       sqlite3_value **argv)
+{
+    MotifCursor *cursor = (MotifCursor *)base;
+    MotifTable *table = (MotifTable *)base->pVtab;
+
+    delete cursor->instances;
+    delete cursor->classifier;
+    cursor->instances = nullptr;
+    cursor->classifier = nullptr;
+    cursor->counts.clear();
+    cursor->position = 0;
+    cursor->rowid = 0;
+    cursor->eof = true;
+
+    const char *edges = argc == 2 ? (const char *)sqlite3_value_text(argv[0])
+                                  : nullptr;
+    cursor->edges = edges != nullptr ? edges : "";
+    cursor->k = argc == 2 ? sqlite3_value_int(argv[1]) : 0;
+    if (edges == nullptr || cursor->k < 2 || cursor->k > MAX_SUBGRAPH_SIZE)
+    {
+        sqlite3_free(table->base.zErrMsg);
+        table->base.zErrMsg = sqlite3_mprintf(
+            "expected an edges table name and 2 <= k <= %d",
+            MAX_SUBGRAPH_SIZE);
+        return SQLITE_ERROR;
+    }
+
+    char *message = nullptr;
+    int rc = loadEdges(table->db, edges, cursor->graph, message);
+    if (rc != SQLITE_OK)
+    {
+        sqlite3_free(table->base.zErrMsg);
+        table->base.zErrMsg = message;
+        return rc;
+    }
+
+    if (table->census)
+    {
+        Census census(cursor->graph, cursor->k);
+        census.run();
+        cursor->counts.assign(census.getCounts().begin(),
+                              census.getCounts().end());
+        cursor->eof = cursor->counts.empty();
+    }
+    else
+    {
+        cursor->instances = new SubgraphGenerator(cursor->graph, cursor->k);
+        cursor->classifier = new Classifier(cursor->k);
+        cursor->eof = !cursor->instances->next();
+    }
+
+    return SQLITE_OK;
+}
+
+//------------------------------------- next -----------------------------------
+// xNext
+static int motifNext(sqlite3_vtab_cursor *base)
+{
+    MotifCursor *cursor = (MotifCursor *)base;
+
+    if (cursor->instances != nullptr)
+        cursor->eof = !cursor->instances->next();
+    else
+        cursor->eof = ++cursor->position >= cursor->counts.size();
+
+    cursor->rowid++;
+    return SQLITE_OK;
+}
+
+//------------------------------------- eof ------------------------------------
+// xEof
+static int motifEof(sqlite3_vtab_cursor *base)
+{
+    return ((MotifCursor *)base)->eof;
+}
+
+//------------------------------------ column ----------------------------------
+// xColumn
+static int motifColumn(sqlite3_vtab_cursor *base, sqlite3_context *context,
+                       int column)
+{
+    MotifCursor *cursor = (MotifCursor *)base;
+    const int k = cursor->k;
+
+    if (column == EDGES_TABLE)
+    {
+        sqlite3_result_text(context, cursor->edges.c_str(), -1,
+                            SQLITE_TRANSIENT);
+        return SQLITE_OK;
+    }
+    if (column == SUBGRAPH_SIZE)
+    {
+        sqlite3_result_int(context, k);
+        return SQLITE_OK;
+    }
+
+    // esu: vertices, class, graph6; motif_census: class, graph6, count
+    uint64_t type;
+    if (cursor->instances != nullptr)
+    {
+        if (column == 0)
+        {
+            int sorted[MAX_SUBGRAPH_SIZE];
+            const int *subgraph = cursor->instances->getSubgraph();
+            copy(subgraph, subgraph + k, sorted);
+            sortSmall(sorted, k);
+
+            string vertices;
+            for (int i = 0; i < k; i++)
+                vertices += (i == 0 ? "" : " ") + to_string(sorted[i]);
+            sqlite3_result_text(context, vertices.c_str(), -1,
+                                SQLITE_TRANSIENT);
+            return SQLITE_OK;
+        }
+
+        type = cursor->classifier->classify(cursor->instances->getMask());
+        column--;
+    }
+    else
+    {
+        const auto &row = cursor->counts[cursor->position];
+        if (column == 2)
+        {
+            sqlite3_result_int64(context, row.second);
+            return SQLITE_OK;
+        }
+        type = row.first;
+    }
+
+    if (column == 0)
+        sqlite3_result_int64(context, (sqlite3_int64)type);
+    else
+        sqlite3_result_text(context, Classifier::toGraph6(type, k).c_str(), -1,
+                            SQLITE_TRANSIENT);
+
+    return SQLITE_OK;
+}
+
+//------------------------------------ rowid -----------------------------------
+// xRowid
+static int motifRowid(sqlite3_vtab_cursor *base, sqlite3_int64 *rowid)
+{
+    *rowid = ((MotifCursor *)base)->rowid;
+    return SQLITE_OK;
+}
+
+//------------------------------------------------------------------------------
+// Eponymous-only module: no xCreate, so the tables exist without CREATE
+static sqlite3_module motifModule =
+{
+    0,                                      // iVersion
+    nullptr,                                // xCreate
+    motifConnect,                           // xConnect
+    motifBestIndex,                         // xBestIndex
+    motifDisconnect,                        // xDisconnect
+    nullptr,                                // xDestroy
+    motifOpen,                              // xOpen
+    motifClose,                             // xClose
+    motifFilter,                            // xFilter
+    motifNext,                              // xNext
+    motifEof,                               // xEof
+    motifColumn,                            // xColumn
+    motifRowid,                             // xRowid
+    nullptr, nullptr, nullptr, nullptr,     // xUpdate ... xCommit
+    nullptr, nullptr, nullptr, nullptr,     // xRollback ... xSavepoint
+    nullptr, nullptr, nullptr               // xRelease ... xShadowName
+};
+
+//------------------------------ sqlite3_nemosql_init --------------------------
+// Entry point of the extension (loaded as "nemosql")
+// Preconditions: called by SQLite when the extension is loaded
+// Postconditions: esu and motif_census are registered on db
+extern "C" int sqlite3_nemosql_init(sqlite3 *db, char **,
+                                    const sqlite3_api_routines *api)
+{
+    SQLITE_EXTENSION_INIT2(api);
+
+    int rc = sqlite3_create_module(db, "esu", &motifModule, nullptr);
+    if (rc == SQLITE_OK)
+        rc = sqlite3_create_module(db, "motif_census", &motifModule,
+                                   (void *)1);
+
+    return rc;
+}
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+//  Stats.cpp
+//------------------------------------------------------------------------------
+// EngineStats holds the hot-path counters of the subgraph enumeration. The
+// counters are only filled in builds compiled with -DNEMO_STATS.
+//
+// ASSUMPTIONS:
+//   -- an EngineStats is only written by one thread at a time
+//
+//------------------------------------------------------------------------------
+
+#include "Stats.h"
+
+#include <algorithm>
+
+//------------------------------------- add ------------------------------------
+// Adds the counters of other to these
+// Preconditions: None
+// Postconditions: Every counter is the sum of both
+void EngineStats::add(const EngineStats &other)
+{
+    for (int d = 0; d <= MAX_SUBGRAPH_SIZE; d++)
+        nodes[d] += other.nodes[d];
+
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+    {
+        extensionSizes[b] += other.extensionSizes[b];
+        rootLeaves[b] += other.rootLeaves[b];
+    }
+
+    roots += other.roots;
+    cacheHits += other.cacheHits;
+    cacheMisses += other.cacheMisses;
+    classifySeconds += other.classifySeconds;
+    enumerateSeconds += other.enumerateSeconds;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes the counters of a size-k enumeration in readable form
+// Preconditions: None
+// Postconditions: The counters are written to out
+void EngineStats::write(ostream &out, const int &k) const
+{
+#ifdef NEMO_STATS
+    out << "Nodes per depth:";
+    for (int d = 1; d <= k; d++)
+        out << " " << d << ":" << nodes[d];
+    out << endl;
+
+    out << "Extension sizes (bucket [2^(b-1), 2^b) : nodes):";
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+        if (extensionSizes[b] > 0)
+            out << " " << b << ":" << extensionSizes[b];
+    out << endl;
+
+    out << "Subgraphs per root (bucket [2^(b-1), 2^b) : roots):";
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+        if (rootLeaves[b] > 0)
+            out << " " << b << ":" << rootLeaves[b];
+    out << endl;
+
+    long long lookups = cacheHits + cacheMisses;
+    out << "Roots = " << roots << ", subgraphs = " << nodes[k]
+        << ", classifier cache hits = " << cacheHits << "/" << lookups;
+    if (lookups > 0)
+        out << " (" << 100.0 * cacheHits / lookups << "%)";
+    out << endl;
+
+    // classifySeconds is extrapolated from sampled calls and can overshoot
+    out << "Classification = " << classifySeconds << " s, traversal = "
+        << max(0.0, enumerateSeconds - classifySeconds)
+        << " s (thread time, classification sampled)" << endl;
+#else
+    (void)k;
+    out << "Statistics are not collected (build with -DNEMO_STATS)" << endl;
+#endif
+}
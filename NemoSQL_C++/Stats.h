@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//  Stats.h
+//------------------------------------------------------------------------------
+// EngineStats holds the hot-path counters of the subgraph enumeration: ESU
+// tree nodes per depth, the distribution of extension-set sizes and of
+// subgraphs per root, time spent classifying versus walking the tree, and the
+// hit rate of the canonical-form cache.
+//
+// Every worker fills its own EngineStats with plain (non-atomic) increments,
+// and the owner folds them together with add() whenever it already holds a
+// lock. The counting statements are wrapped in STATS(...), which expands to
+// nothing unless the tree is compiled with -DNEMO_STATS, so a production build
+// carries no counting code at all.
+//
+// ASSUMPTIONS:
+//   -- an EngineStats is only written by one thread at a time
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__Stats__
+#define __NemoSQL__Stats__
+
+#include <iostream>
+#include "Classifier.h"
+
+using namespace std;
+
+#ifdef NEMO_STATS
+#define STATS(statement) statement
+#else
+#define STATS(statement)
+#endif
+
+const int HISTOGRAM_BUCKETS = 40;           // power-of-two buckets
+
+struct EngineStats
+{
+    long long nodes[MAX_SUBGRAPH_SIZE + 1] = {};    // tree nodes per depth
+    long long extensionSizes[HISTOGRAM_BUCKETS] = {};   // |Vextension|
+    long long rootLeaves[HISTOGRAM_BUCKETS] = {};   // subgraphs per root
+    long long roots = 0;                    // roots enumerated
+    long long cacheHits = 0;                // classifications found cached
+    long long cacheMisses = 0;              // classifications computed
+    double classifySeconds = 0;             // time inside the classifier
+    double enumerateSeconds = 0;            // time of whole roots
+
+
+    //--------------------------------- bucket ---------------------------------
+    // Histogram bucket of value: 0 holds 0, bucket b holds [2^(b-1), 2^b)
+    // Preconditions: value >= 0
+    // Postconditions: Returns a bucket in [0, HISTOGRAM_BUCKETS)
+    static int bucket(const long long &value)
+    {
+        int b = value == 0 ? 0 : 64 - __builtin_clzll((unsigned long long)value);
+        return b < HISTOGRAM_BUCKETS ? b : HISTOGRAM_BUCKETS - 1;
+    }
+
+
+    //----------------------------------- add ----------------------------------
+    // Adds the counters of other to these
+    // Preconditions: None
+    // Postconditions: Every counter is the sum of both
+    void add(const EngineStats &other);
+
+
+    //---------------------------------- write ---------------------------------
+    // Writes the counters of a size-k enumeration in readable form
+    // Preconditions: None
+    // Postconditions: The counters are written to out
+    void write(ostream &out, const int &k) const;
+
+};
+
+#endif /* defined(__NemoSQL__Stats__) */
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+//  SubgraphGenerator.cpp
+//------------------------------------------------------------------------------
+// SubgraphGenerator walks the same ESU tree as Graph::enumerateSubgraph, but
+// is pulled by the caller instead of pushing into a visitor: every call to
+// next() resumes the walk where the previous call stopped and produces one
+// more connected size-k subgraph.
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a SubgraphGenerator walks it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "SubgraphGenerator.h"
+
+#include <algorithm>
+
+//--------------------------------- Constructor --------------------------------
+// Creates a generator of the size-k subgraphs of graph whose smallest
+// vertex is in [first, last); last < 0 means up to graph.size()
+// Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: The generator is positioned before the first instance
+SubgraphGenerator::SubgraphGenerator(const Graph &graph, const int &k,
+                                     const int &first, const int &last)
+    : graph(graph), k(k), root(first - 1),
+      last(last < 0 ? graph.size() : last), masks(k, 0)
+{
+    state.reset(k, graph.size());
+
+    // An extension never holds more than the neighbors of a whole prefix, so
+    // reserving that much up front keeps every later assignment in place
+    size_t degree = 0;
+    for (int v = 0; v < graph.size(); v++)
+        degree = max(degree, graph.neighbors(v).size());
+
+    for (vector<int> &extension : state.extension)
+        extension.reserve(degree * (k - 1));
+}
+
+//------------------------------------ next ------------------------------------
+// Advances to the next instance
+// Preconditions: None
+// Postconditions: Returns false once every instance has been produced;
+//                 otherwise getSubgraph() and getMask() describe the next one
+bool SubgraphGenerator::next()
+{
+    for (;;)
+    {
+        if (depth == 0 && !nextRoot())
+            return false;
+
+        vector<int> &extension = state.extension[depth];
+
+        // Leaves are read off the extension without consuming it
+        if (depth == k - 1)
+        {
+            if (leaf < extension.size())
+            {
+                int w = extension[leaf++];
+                state.subgraph[depth] = w;
+                mask = masks[depth] |
+                       (uint64_t)state.adjacent[w] << depth * (depth - 1) / 2;
+                return true;
+            }
+
+            pop();
+            continue;
+        }
+
+        if (extension.empty())
+        {
+            pop();
+            continue;
+        }
+
+        int w = extension.back();
+        extension.pop_back();
+
+        vector<int> &extension2 = state.extension[depth + 1];
+        extension2 = extension;
+        for (int vertex : graph.neighbors(w))
+            if (vertex > root && state.adjacent[vertex] == 0)
+                extension2.push_back(vertex);
+
+        state.subgraph[depth] = w;
+        masks[depth + 1] = masks[depth] |
+            (uint64_t)state.adjacent[w] << depth * (depth - 1) / 2;
+
+        for (int vertex : graph.neighbors(w))
+            state.adjacent[vertex] |= 1u << depth;
+
+        depth++;
+        leaf = 0;
+    }
+}
+
+//--------------------------------- getSubgraph --------------------------------
+// Vertices of the current instance, the root first
+// Preconditions: The last call to next() returned true
+// Postconditions: Returns k vertex IDs, valid until the next call to next()
+const int *SubgraphGenerator::getSubgraph() const
+{
+    return state.subgraph.data();
+}
+
+//----------------------------------- getMask ----------------------------------
+// Packed adjacency of the current instance (see Classifier.h)
+// Preconditions: The last call to next() returned true
+// Postconditions: Returns the mask of getSubgraph()
+uint64_t SubgraphGenerator::getMask() const
+{
+    return mask;
+}
+
+//----------------------------------- getSize ----------------------------------
+// Size of the instances produced
+// Preconditions: None
+// Postconditions: Returns k
+int SubgraphGenerator::getSize() const
+{
+    return k;
+}
+
+//------------------------------------ begin -----------------------------------
+// Advances to the next instance and returns an iterator on it
+// Preconditions: None
+// Postconditions: Returns end() if there is no next instance
+SubgraphGenerator::iterator SubgraphGenerator::begin()
+{
+    return iterator(next() ? this : nullptr);
+}
+
+//------------------------------------- end ------------------------------------
+// Iterator past the last instance
+// Preconditions: None
+// Postconditions: Returns an exhausted iterator
+SubgraphGenerator::iterator SubgraphGenerator::end()
+{
+    return iterator(nullptr);
+}
+
+//------------------------------ PRIVATE: nextRoot -----------------------------
+// Moves to the next root with at least one neighbor
+// Preconditions: depth == 0
+// Postconditions: Returns false if no root is left; otherwise depth == 1
+//                 and the root is the prefix
+bool SubgraphGenerator::nextRoot()
+{
+    do
+    {
+        if (++root >= last)
+        {
+            root = last;
+            return false;
+        }
+    } while (graph.neighbors(root).empty());
+
+    state.subgraph[0] = root;
+
+    vector<int> &extension = state.extension[1];
+    extension.clear();
+    for (int w : graph.neighbors(root))
+    {
+        state.adjacent[w] |= 1;
+        if (w > root)
+            extension.push_back(w);
+    }
+
+    masks[1] = 0;
+    depth = 1;
+    leaf = 0;
+
+    return true;
+}
+
+//--------------------------------- PRIVATE: pop -------------------------------
+// Leaves the current depth and takes its last vertex off the prefix
+// Preconditions: depth >= 1
+// Postconditions: depth is one less
+void SubgraphGenerator::pop()
+{
+    state.extension[depth].clear();
+    depth--;
+
+    for (int vertex : graph.neighbors(state.subgraph[depth]))
+        state.adjacent[vertex] &= ~(1u << depth);
+}
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+//  SubgraphGenerator.h
+//------------------------------------------------------------------------------
+// SubgraphGenerator walks the same ESU tree as Graph::enumerateSubgraph, but
+// is pulled by the caller instead of pushing into a visitor: every call to
+// next() resumes the walk where the previous call stopped and produces one
+// more connected size-k subgraph. The recursion is unrolled into one frame per
+// depth (extension buffer and prefix mask), all allocated by the constructor,
+// so stopping after the first few instances is as cheap as it sounds and
+// pausing or resuming never reallocates.
+// features are included:
+//   -- next() / getSubgraph() / getMask() pull interface
+//   -- begin() / end() so that a generator can drive a range-based for loop
+//   -- optional root range, to walk only part of the graph
+//
+// ASSUMPTIONS:
+//   -- the Graph is not modified while a SubgraphGenerator walks it
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__SubgraphGenerator__
+#define __NemoSQL__SubgraphGenerator__
+
+#include <cstdint>
+#include <vector>
+#include "Enumeration.h"
+#include "Graph.h"
+
+using namespace std;
+
+class SubgraphGenerator
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a generator of the size-k subgraphs of graph whose smallest
+    // vertex is in [first, last); last < 0 means up to graph.size()
+    // Preconditions: 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: The generator is positioned before the first instance
+    SubgraphGenerator(const Graph &graph, const int &k, const int &first = 0,
+                      const int &last = -1);
+
+
+    //---------------------------------- next ----------------------------------
+    // Advances to the next instance
+    // Preconditions: None
+    // Postconditions: Returns false once every instance has been produced;
+    //                 otherwise getSubgraph() and getMask() describe the next one
+    bool next();
+
+
+    //------------------------------- getSubgraph ------------------------------
+    // Vertices of the current instance, the root first
+    // Preconditions: The last call to next() returned true
+    // Postconditions: Returns k vertex IDs, valid until the next call to next()
+    const int *getSubgraph() const;
+
+
+    //--------------------------------- getMask --------------------------------
+    // Packed adjacency of the current instance (see Classifier.h)
+    // Preconditions: The last call to next() returned true
+    // Postconditions: Returns the mask of getSubgraph()
+    uint64_t getMask() const;
+
+
+    //--------------------------------- getSize --------------------------------
+    // Size of the instances produced
+    // Preconditions: None
+    // Postconditions: Returns k
+    int getSize() const;
+
+
+    // Input iterator over the remaining instances, for range-based for loops
+    class iterator
+    {
+    public:
+        iterator(SubgraphGenerator *generator) : generator(generator) {}
+
+        const SubgraphGenerator &operator*() const { return *generator; }
+
+        iterator &operator++()
+        {
+            if (!generator->next())
+                generator = nullptr;
+            return *this;
+        }
+
+        bool operator!=(const iterator &other) const
+        {
+            return generator != other.generator;
+        }
+
+    private:
+        SubgraphGenerator *generator;       // nullptr once exhausted
+    };
+
+
+    //---------------------------------- begin ---------------------------------
+    // Advances to the next instance and returns an iterator on it
+    // Preconditions: None
+    // Postconditions: Returns end() if there is no next instance
+    iterator begin();
+
+
+    //----------------------------------- end ----------------------------------
+    // Iterator past the last instance
+    // Preconditions: None
+    // Postconditions: Returns an exhausted iterator
+    iterator end();
+
+
+private:
+    const Graph &graph;                     // graph being walked
+    int k;                                  // subgraph size
+    int root;                               // root of the current tree
+    int last;                               // one past the last root
+    int depth = 0;                          // vertices in the current prefix
+    size_t leaf = 0;                        // next leaf at depth k-1
+    uint64_t mask = 0;                      // mask of the current instance
+    vector<uint64_t> masks;                 // prefix mask of every depth
+    EnumerationState state;                 // per-depth frames
+
+
+    //--------------------------- PRIVATE: nextRoot ----------------------------
+    // Moves to the next root with at least one neighbor
+    // Preconditions: depth == 0
+    // Postconditions: Returns false if no root is left; otherwise depth == 1
+    //                 and the root is the prefix
+    bool nextRoot();
+
+    //------------------------------ PRIVATE: pop ------------------------------
+    // Leaves the current depth and takes its last vertex off the prefix
+    // Preconditions: depth >= 1
+    // Postconditions: depth is one less
+    void pop();
+
+};
+
+#endif /* defined(__NemoSQL__SubgraphGenerator__) */
@@ -0,0 +1,311 @@
+//------------------------------------------------------------------------------
+//  SubgraphStore.cpp
+//------------------------------------------------------------------------------
+// SubgraphStore writes a Graph and its size-k subgraph instances into an
+// SQLite database through prepared statements and large transactions.
+//
+// ASSUMPTIONS:
+//   -- the program is linked with -lsqlite3
+//   -- one thread uses a SubgraphStore at a time
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#include "SubgraphStore.h"
+
+#include <algorithm>
+
+//--------------------------------- Constructor --------------------------------
+// Creates a store that is not connected to a database
+// Preconditions: None
+// Postconditions: open must be called before anything is written
+SubgraphStore::SubgraphStore()
+    : db(nullptr), insert(nullptr), classifier(nullptr), rows(0),
+      transactionRows(1), failed(false) {}
+
+//--------------------------------- Destructor ---------------------------------
+// Closes the database
+// Preconditions: None
+// Postconditions: Open transactions are rolled back
+SubgraphStore::~SubgraphStore()
+{
+    close();
+}
+
+//------------------------------------ open ------------------------------------
+// Opens or creates the database file path
+// Preconditions: None
+// Postconditions: Returns false if the database cannot be opened; the journal
+//                 is in WAL mode
+bool SubgraphStore::open(const string &path)
+{
+    close();
+
+    if (sqlite3_open(path.c_str(), &db) != SQLITE_OK)
+    {
+        error = sqlite3_errmsg(db);
+        close();
+        return false;
+    }
+
+    // WAL lets readers run during a load, and with it NORMAL sync is still
+    // safe against corruption while syncing only at checkpoints
+    if (!exec("PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL;"
+              "PRAGMA cache_size = -262144;"))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------ close -----------------------------------
+// Closes the database
+// Preconditions: None
+// Postconditions: Nothing is open
+void SubgraphStore::close()
+{
+    sqlite3_finalize(insert);
+    insert = nullptr;
+
+    // Closing with a transaction open rolls it back
+    sqlite3_close(db);
+    db = nullptr;
+}
+
+//--------------------------------- storeEdges ---------------------------------
+// Replaces the edges table by the edges of graph
+// Preconditions: open succeeded
+// Postconditions: Returns false on an SQLite error
+bool SubgraphStore::storeEdges(const Graph &graph)
+{
+    if (!exec("DROP TABLE IF EXISTS edges;"
+              "CREATE TABLE edges (n1 INTEGER NOT NULL, n2 INTEGER NOT NULL);"
+              "BEGIN"))
+        return false;
+
+    sqlite3_stmt *edge = prepare("INSERT INTO edges VALUES (?, ?)");
+    bool ok = edge != nullptr;
+
+    for (int u = 0; ok && u < graph.size(); u++)
+        for (int v : graph.neighbors(u))
+        {
+            if (u > v)
+                continue;
+
+            sqlite3_bind_int(edge, 1, u);
+            sqlite3_bind_int(edge, 2, v);
+            if (!(ok = step(edge)))
+                break;
+        }
+
+    sqlite3_finalize(edge);
+    if (!ok)
+    {
+        exec("ROLLBACK");
+        return false;
+    }
+
+    return exec("COMMIT;"
+                "CREATE INDEX edges_n1 ON edges (n1);"
+                "CREATE INDEX edges_n2 ON edges (n2)");
+}
+
+//------------------------------- storeSubgraphs -------------------------------
+// Replaces the size<k> table by the connected size-k subgraphs of graph and
+// their rows of classes
+// Preconditions: open succeeded; 2 <= k <= MAX_SUBGRAPH_SIZE
+// Postconditions: Returns the number of rows written, or -1 on an SQLite
+//                 error; on an error the size<k> table is dropped, even if
+//                 some of its transactions were already committed, and the
+//                 classes rows of size k are left as they were
+long long SubgraphStore::storeSubgraphs(const Graph &graph, const int &k,
+                                        const StoreOptions &options)
+{
+    const string table = "size" + to_string(k);
+
+    string columns, values;
+    for (int i = 1; i <= k; i++)
+    {
+        columns += "n" + to_string(i) + " INTEGER NOT NULL, ";
+        values += "?, ";
+    }
+
+    if (!exec("DROP TABLE IF EXISTS " + table + ";"
+              "CREATE TABLE " + table + " (" + columns +
+              "class INTEGER NOT NULL);"
+              "CREATE TABLE IF NOT EXISTS classes (k INTEGER NOT NULL, "
+              "class INTEGER NOT NULL, graph6 TEXT NOT NULL, "
+              "count INTEGER NOT NULL, PRIMARY KEY (k, class))"))
+        return -1;
+
+    insert = prepare("INSERT INTO " + table + " VALUES (" + values + "?)");
+    if (insert == nullptr)
+        return discard(table);
+    if (!exec("BEGIN"))
+    {
+        sqlite3_finalize(insert);
+        insert = nullptr;
+        return discard(table);
+    }
+
+    Classifier classes(k);
+    classifier = &classes;
+    counts.clear();
+    rows = 0;
+    transactionRows = max(1LL, options.transactionRows);
+    failed = false;
+
+    graph.enumerateSubgraph(k, *this);
+
+    sqlite3_finalize(insert);
+    insert = nullptr;
+    classifier = nullptr;
+
+    // Every transactionRows rows are already committed, so a failure has to
+    // drop the table rather than only roll back the last transaction
+    if (failed || !exec("COMMIT"))
+        return discard(table);
+
+    // One index build sorts the finished table once, instead of a B-tree
+    // insert per row during the load
+    if (options.indexes)
+    {
+        string indexes = "BEGIN;";
+        indexes += "CREATE INDEX " + table + "_class ON " + table +
+                   " (class);";
+        for (int i = 1; i <= k; i++)
+            indexes += "CREATE INDEX " + table + "_n" + to_string(i) + " ON " +
+                       table + " (n" + to_string(i) + ");";
+        indexes += "COMMIT";
+
+        if (!exec(indexes))
+            return discard(table);
+    }
+
+    if (!exec("BEGIN; DELETE FROM classes WHERE k = " + to_string(k)))
+        return discard(table);
+
+    sqlite3_stmt *row = prepare("INSERT INTO classes VALUES (?, ?, ?, ?)");
+    bool ok = row != nullptr;
+    for (auto entry = counts.begin(); ok && entry != counts.end(); entry++)
+    {
+        const string graph6 = Classifier::toGraph6(entry->first, k);
+        sqlite3_bind_int(row, 1, k);
+        sqlite3_bind_int64(row, 2, (sqlite3_int64)entry->first);
+        sqlite3_bind_text(row, 3, graph6.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(row, 4, entry->second);
+        ok = step(row);
+    }
+
+    sqlite3_finalize(row);
+    if (!ok || !exec("COMMIT"))
+        return discard(table);
+
+    return rows;
+}
+
+//---------------------------------- getError ----------------------------------
+// Message of the last failure
+// Preconditions: None
+// Postconditions: Returns an empty string if nothing failed
+const string &SubgraphStore::getError() const
+{
+    return error;
+}
+
+//------------------------------------ visit -----------------------------------
+// Writes one instance
+// Preconditions: called by Graph::enumerateSubgraph during storeSubgraphs
+// Postconditions: The instance is bound to the insert statement and stepped;
+//                 the transaction is committed every transactionRows rows
+void SubgraphStore::visit(const int *subgraph, const int &k,
+                          const uint64_t &mask)
+{
+    // The enumeration cannot be stopped, so after a failure the remaining
+    // instances are skipped
+    if (failed)
+        return;
+
+    int sorted[MAX_SUBGRAPH_SIZE];
+    copy(subgraph, subgraph + k, sorted);
+    sortSmall(sorted, k);
+
+    const uint64_t type = classifier->classify(mask);
+    for (int i = 0; i < k; i++)
+        sqlite3_bind_int(insert, i + 1, sorted[i]);
+    sqlite3_bind_int64(insert, k + 1, (sqlite3_int64)type);
+
+    if (!step(insert))
+    {
+        failed = true;
+        return;
+    }
+
+    counts[type]++;
+    if (++rows % transactionRows == 0 && !exec("COMMIT; BEGIN"))
+        failed = true;
+}
+
+//-------------------------------- PRIVATE: exec -------------------------------
+// Runs statements without results
+// Preconditions: db is open
+// Postconditions: Returns false, keeping the message, on an error
+bool SubgraphStore::exec(const string &sql)
+{
+    char *message = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &message) == SQLITE_OK)
+        return true;
+
+    error = message != nullptr ? message : sqlite3_errmsg(db);
+    sqlite3_free(message);
+    return false;
+}
+
+//------------------------------ PRIVATE: discard ------------------------------
+// Abandons a failed storeSubgraphs
+// Preconditions: db is open; error holds the message of the failure
+// Postconditions: The open transaction, if any, is rolled back and table is
+//                 dropped; error is kept; returns -1
+long long SubgraphStore::discard(const string &table)
+{
+    const string message = error;
+    exec("ROLLBACK");
+    exec("DROP TABLE IF EXISTS " + table);
+    error = message;
+
+    return -1;
+}
+
+//------------------------------ PRIVATE: prepare ------------------------------
+// Compiles one statement
+// Preconditions: db is open
+// Postconditions: Returns nullptr, keeping the message, on an error
+sqlite3_stmt *SubgraphStore::prepare(const string &sql)
+{
+    sqlite3_stmt *statement = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement, nullptr) !=
+        SQLITE_OK)
+    {
+        error = sqlite3_errmsg(db);
+        sqlite3_finalize(statement);
+        return nullptr;
+    }
+
+    return statement;
+}
+
+//------------------------------- PRIVATE: step --------------------------------
+// Runs a bound insert and makes it ready for the next values
+// Preconditions: statement was prepared on db
+// Postconditions: Returns false, keeping the message, on an error
+bool SubgraphStore::step(sqlite3_stmt *statement)
+{
+    bool done = sqlite3_step(statement) == SQLITE_DONE;
+    if (!done)
+        error = sqlite3_errmsg(db);
+
+    sqlite3_reset(statement);
+    return done;
+}
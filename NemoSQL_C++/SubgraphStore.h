@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//  SubgraphStore.h
+//------------------------------------------------------------------------------
+// SubgraphStore writes a Graph and its size-k subgraph instances into an
+// SQLite database, so that motifs can be queried with SQL as in the NemoSQL
+// prototype (NemoSQL_Binary/Graph.py), but fast enough for networks with
+// millions of instances.
+//
+// Tables (k is the subgraph size):
+//   edges(n1, n2)                          one row per edge, n1 < n2
+//   size<k>(n1, ..., nk, class)            one row per connected k-set,
+//                                          n1 < ... < nk; class is the
+//                                          canonical adjacency mask
+//   classes(k, class, graph6, count)       one row per class of each size
+//
+// Every row goes through one prepared statement per table, with its values
+// bound rather than spliced into SQL text. Rows are committed in large
+// explicit transactions (transactionRows rows each) with the journal in WAL
+// mode, and the indexes on size<k> are only created once all its rows are in,
+// which is much cheaper than keeping them up to date row by row.
+//
+// Errors from SQLite make the call return false (or -1) and are kept for
+// getError(). Since a large load commits as it goes, a failed storeSubgraphs
+// drops its size<k> table instead of leaving part of it behind.
+//
+// ASSUMPTIONS:
+//   -- the program is linked with -lsqlite3
+//   -- one thread uses a SubgraphStore at a time
+//   -- 2 <= k <= MAX_SUBGRAPH_SIZE
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__SubgraphStore__
+#define __NemoSQL__SubgraphStore__
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <sqlite3.h>
+#include "Classifier.h"
+#include "Enumeration.h"
+#include "Graph.h"
+
+using namespace std;
+
+struct StoreOptions
+{
+    long long transactionRows = 1 << 20;    // rows per committed transaction
+    bool indexes = true;                    // index size<k> after loading
+};
+
+class SubgraphStore
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a store that is not connected to a database
+    // Preconditions: None
+    // Postconditions: open must be called before anything is written
+    SubgraphStore();
+
+
+    //------------------------------- Destructor -------------------------------
+    // Closes the database
+    // Preconditions: None
+    // Postconditions: Open transactions are rolled back
+    ~SubgraphStore();
+
+
+    //---------------------------------- open ----------------------------------
+    // Opens or creates the database file path
+    // Preconditions: None
+    // Postconditions: Returns false if the database cannot be opened; the
+    //                 journal is in WAL mode
+    bool open(const string &path);
+
+
+    //---------------------------------- close ---------------------------------
+    // Closes the database
+    // Preconditions: None
+    // Postconditions: Nothing is open
+    void close();
+
+
+    //------------------------------- storeEdges -------------------------------
+    // Replaces the edges table by the edges of graph
+    // Preconditions: open succeeded
+    // Postconditions: Returns false on an SQLite error
+    bool storeEdges(const Graph &graph);
+
+
+    //----------------------------- storeSubgraphs -----------------------------
+    // Replaces the size<k> table by the connected size-k subgraphs of graph
+    // and their rows of classes
+    // Preconditions: open succeeded; 2 <= k <= MAX_SUBGRAPH_SIZE
+    // Postconditions: Returns the number of rows written, or -1 on an SQLite
+    //                 error; on an error the size<k> table is dropped, even
+    //                 if some of its transactions were already committed,
+    //                 and the classes rows of size k are left as they were
+    long long storeSubgraphs(const Graph &graph, const int &k,
+                             const StoreOptions &options = StoreOptions());
+
+
+    //-------------------------------- getError --------------------------------
+    // Message of the last failure
+    // Preconditions: None
+    // Postconditions: Returns an empty string if nothing failed
+    const string &getError() const;
+
+
+    //---------------------------------- visit ---------------------------------
+    // Writes one instance
+    // Preconditions: called by Graph::enumerateSubgraph during storeSubgraphs
+    // Postconditions: The instance is bound to the insert statement and
+    //                 stepped; the transaction is committed every
+    //                 transactionRows rows
+    void visit(const int *subgraph, const int &k, const uint64_t &mask);
+
+
+private:
+    sqlite3 *db;                            // open database, or nullptr
+    sqlite3_stmt *insert;                   // insert into size<k>
+    Classifier *classifier;                 // classes of storeSubgraphs
+    unordered_map<uint64_t, long long> counts;  // class -> rows written
+    long long rows;                         // rows of the current table
+    long long transactionRows;              // rows per transaction
+    bool failed;                            // an insert failed
+    string error;                           // message of the last failure
+
+
+    //------------------------------ PRIVATE: exec -----------------------------
+    // Runs statements without results
+    // Preconditions: db is open
+    // Postconditions: Returns false, keeping the message, on an error
+    bool exec(const string &sql);
+
+
+    //---------------------------- PRIVATE: discard ----------------------------
+    // Abandons a failed storeSubgraphs
+    // Preconditions: db is open; error holds the message of the failure
+    // Postconditions: The open transaction, if any, is rolled back and table
+    //                 is dropped; error is kept; returns -1
+    long long discard(const string &table);
+
+
+    //---------------------------- PRIVATE: prepare ----------------------------
+    // Compiles one statement
+    // Preconditions: db is open
+    // Postconditions: Returns nullptr, keeping the message, on an error
+    sqlite3_stmt *prepare(const string &sql);
+
+
+    //----------------------------- PRIVATE: step ------------------------------
+    // Runs a bound insert and makes it ready for the next values
+    // Preconditions: statement was prepared on db
+    // Postconditions: Returns false, keeping the message, on an error
+    bool step(sqlite3_stmt *statement);
+
+};
+
+#endif /* defined(__NemoSQL__SubgraphStore__) */
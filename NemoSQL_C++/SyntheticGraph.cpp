@@ -0,0 +1,253 @@
+//------------------------------------------------------------------------------
+//  SyntheticGraph.cpp
+//------------------------------------------------------------------------------
+// SyntheticGraph generates random undirected graphs for scaling benchmarks and
+// writes them in the edge-list format Graph::buildGraph reads.
+//
+// Edges are collected as packed 64-bit keys u << 32 | v (u < v) and sorted
+// once at the end, which takes far less memory than adjacency sets when the
+// graph has tens of millions of edges.
+//
+// ASSUMPTIONS:
+//   -- vertices are numbered 0 .. n-1; a graph has no loops or multi-edges
+//
+//------------------------------------------------------------------------------
+
+#include "SyntheticGraph.h"
+
+#include <algorithm>
+#include <cmath>
+
+const int DUPLICATION_DRAWS = 1000;         // empty copies before a forced link
+
+//--------------------------------- Constructor --------------------------------
+// Creates a generator for the given parameters
+// Preconditions: options.vertices >= 2
+// Postconditions: No graph is generated yet
+SyntheticGraph::SyntheticGraph(const SyntheticOptions &options)
+    : options(options), random(options.seed) {}
+
+//---------------------------------- generate ----------------------------------
+// Generates a graph of the named model
+// Preconditions: None
+// Postconditions: Returns false if model is unknown; otherwise getEdges()
+//                 holds the edges, each once as (u, v) with u < v, sorted
+bool SyntheticGraph::generate(const string &model)
+{
+    edges.clear();
+    random = Random(options.seed);
+
+    if (model == "erdos-renyi")
+        erdosRenyi();
+    else if (model == "chung-lu")
+        chungLu();
+    else if (model == "barabasi")
+        barabasi();
+    else if (model == "duplication")
+        duplication();
+    else
+        return false;
+
+    deduplicate();
+    return true;
+}
+
+//---------------------------------- getEdges ----------------------------------
+// Edges of the last generated graph
+// Preconditions: None
+// Postconditions: Returns the edges packed as u << 32 | v with u < v
+const vector<uint64_t> &SyntheticGraph::getEdges() const
+{
+    return edges;
+}
+
+//------------------------------------ write -----------------------------------
+// Writes the edges as an edge list
+// Preconditions: None
+// Postconditions: One "u\tv" line per edge is written to out
+void SyntheticGraph::write(ostream &out) const
+{
+    for (uint64_t edge : edges)
+        out << (edge >> 32) << '\t' << (edge & 0xffffffff) << '\n';
+    out.flush();
+}
+
+//-------------------------------- PRIVATE: add --------------------------------
+// Adds the edge {u, v} unless it is a loop
+// Preconditions: 0 <= u, v < options.vertices
+// Postconditions: The packed edge is appended; duplicates are removed by
+//                 deduplicate()
+void SyntheticGraph::add(const uint64_t &u, const uint64_t &v)
+{
+    if (u < v)
+        edges.push_back(u << 32 | v);
+    else if (v < u)
+        edges.push_back(v << 32 | u);
+}
+
+//---------------------------- PRIVATE: deduplicate ----------------------------
+// Sorts the edges and drops repeated ones
+// Preconditions: None
+// Postconditions: edges is sorted and holds every edge once
+void SyntheticGraph::deduplicate()
+{
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+}
+
+//---------------------------- PRIVATE: erdosRenyi -----------------------------
+// G(n, m) with m = n * degree / 2
+// Preconditions: m does not exceed the number of vertex pairs
+// Postconditions: edges holds m distinct uniformly chosen edges
+void SyntheticGraph::erdosRenyi()
+{
+    const uint64_t n = options.vertices;
+    const size_t m = (size_t)min(n * options.degree / 2, n * (n - 1) / 2.0);
+
+    // Draw the missing number of pairs and drop repeats until there are m
+    while (edges.size() < m)
+    {
+        for (size_t missing = m - edges.size(); missing > 0; )
+        {
+            uint64_t u = random.uniform(n), v = random.uniform(n);
+            if (u != v)
+            {
+                add(u, v);
+                missing--;
+            }
+        }
+        deduplicate();
+    }
+}
+
+//------------------------------ PRIVATE: chungLu ------------------------------
+// Chung-Lu graph with power-law expected degrees
+// Preconditions: options.exponent > 2
+// Postconditions: n * degree / 2 endpoint pairs were drawn proportionally
+//                 to the vertex weights; repeated pairs are kept once
+void SyntheticGraph::chungLu()
+{
+    const int n = options.vertices;
+    const size_t m = (size_t)(n * options.degree / 2);
+
+    // Weight of vertex i is (i + 1)^(-1 / (exponent - 1)), which gives a
+    // degree distribution with tail P(d) ~ d^-exponent. cumulative[i] is the
+    // sum of the weights of vertices 0 .. i
+    vector<double> cumulative(n);
+    double total = 0;
+    for (int i = 0; i < n; i++)
+    {
+        total += pow(i + 1.0, -1.0 / (options.exponent - 1));
+        cumulative[i] = total;
+    }
+
+    auto draw = [&]()
+    {
+        double target = random.probability() * total;
+        size_t i = upper_bound(cumulative.begin(), cumulative.end(), target)
+                   - cumulative.begin();
+        return (uint64_t)min(i, (size_t)n - 1);
+    };
+
+    edges.reserve(m);
+    for (size_t e = 0; e < m; e++)
+        add(draw(), draw());
+}
+
+//------------------------------ PRIVATE: barabasi -----------------------------
+// Barabasi-Albert preferential attachment
+// Preconditions: None
+// Postconditions: Every vertex after the first degree / 2 + 1 ones is
+//                 linked to degree / 2 distinct earlier vertices chosen
+//                 proportionally to their degree
+void SyntheticGraph::barabasi()
+{
+    const int n = options.vertices;
+    const int m = max(1, min((int)(options.degree / 2), n - 1));
+
+    // Every edge puts both endpoints into ends, so a uniform pick from ends
+    // is a pick proportional to degree. The first m + 1 vertices form a clique
+    vector<uint32_t> ends;
+    ends.reserve(2 * (size_t)m * n);
+    edges.reserve((size_t)m * n);
+
+    for (int v = 1; v <= m; v++)
+        for (int u = 0; u < v; u++)
+        {
+            add(u, v);
+            ends.push_back(u);
+            ends.push_back(v);
+        }
+
+    vector<uint32_t> targets;
+    for (int v = m + 1; v < n; v++)
+    {
+        targets.clear();
+        while ((int)targets.size() < m)
+        {
+            uint32_t u = ends[random.uniform(ends.size())];
+            if (find(targets.begin(), targets.end(), u) == targets.end())
+                targets.push_back(u);
+        }
+
+        for (uint32_t u : targets)
+        {
+            add(u, v);
+            ends.push_back(u);
+            ends.push_back(v);
+        }
+    }
+}
+
+//---------------------------- PRIVATE: duplication ----------------------------
+// Duplication-divergence growth from a single edge
+// Preconditions: None
+// Postconditions: Vertices were added until there are options.vertices;
+//                 a copy that ended up without edges was drawn again, up to
+//                 DUPLICATION_DRAWS times, and then linked to the vertex it
+//                 copied
+void SyntheticGraph::duplication()
+{
+    const int n = options.vertices;
+    vector<vector<uint32_t>> adjacency(n);
+
+    adjacency[0].push_back(1);
+    adjacency[1].push_back(0);
+
+    vector<uint32_t> copied;
+    int draws = 0;
+    for (int v = 2; v < n; )
+    {
+        uint32_t u = (uint32_t)random.uniform(v);
+
+        copied.clear();
+        for (uint32_t w : adjacency[u])
+            if (random.probability() < options.retain)
+                copied.push_back(w);
+        if (random.probability() < options.link)
+            copied.push_back(u);
+
+        // With retain and link near 0 a copy may never keep an edge, so
+        // after DUPLICATION_DRAWS empty copies it is linked to its template
+        if (copied.empty() && ++draws < DUPLICATION_DRAWS)
+            continue;
+        if (copied.empty())
+            copied.push_back(u);
+        draws = 0;
+
+        for (uint32_t w : copied)
+        {
+            adjacency[v].push_back(w);
+            adjacency[w].push_back(v);
+        }
+        v++;
+    }
+
+    for (int v = 0; v < n; v++)
+    {
+        for (uint32_t w : adjacency[v])
+            if ((int)w > v)
+                add(v, w);
+        vector<uint32_t>().swap(adjacency[v]);
+    }
+}
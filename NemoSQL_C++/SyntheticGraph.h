@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+//  SyntheticGraph.h
+//------------------------------------------------------------------------------
+// SyntheticGraph generates random undirected graphs for scaling benchmarks and
+// writes them in the edge-list format Graph::buildGraph reads. The models are:
+//   -- erdos-renyi  G(n, m) with m = n * degree / 2 distinct edges
+//   -- chung-lu     expected degrees following a power law with the given
+//                   exponent and average degree
+//   -- barabasi     preferential attachment, degree / 2 edges per new vertex
+//   -- duplication  duplication-divergence: a new vertex copies a random
+//                   vertex, keeps each of its edges with probability retain
+//                   and links to it with probability link (a PPI-like model)
+// The output depends only on the model, its parameters and the seed: random
+// numbers come from Random and are turned into integers and probabilities by
+// hand rather than through the standard distributions, whose results differ
+// between library implementations.
+//
+// ASSUMPTIONS:
+//   -- vertices are numbered 0 .. n-1; a graph has no loops or multi-edges
+//   -- the edges fit in memory (8 bytes per edge, plus the adjacency lists of
+//      the duplication model)
+//
+//------------------------------------------------------------------------------
+
+#ifndef __NemoSQL__SyntheticGraph__
+#define __NemoSQL__SyntheticGraph__
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Random.h"
+
+using namespace std;
+
+struct SyntheticOptions
+{
+    int vertices = 1000000;                 // n
+    double degree = 10;                     // average degree asked for
+    double exponent = 2.5;                  // power-law exponent (chung-lu)
+    double retain = 0.4;                    // edge kept on duplication
+    double link = 0.1;                      // edge to the duplicated vertex
+    uint64_t seed = 1;                      // random seed
+};
+
+class SyntheticGraph
+{
+public:
+
+    //------------------------------- Constructor ------------------------------
+    // Creates a generator for the given parameters
+    // Preconditions: options.vertices >= 2
+    // Postconditions: No graph is generated yet
+    SyntheticGraph(const SyntheticOptions &options);
+
+
+    //-------------------------------- generate --------------------------------
+    // Generates a graph of the named model
+    // Preconditions: None
+    // Postconditions: Returns false if model is unknown; otherwise getEdges()
+    //                 holds the edges, each once as (u, v) with u < v, sorted
+    bool generate(const string &model);
+
+
+    //--------------------------------- getEdges -------------------------------
+    // Edges of the last generated graph
+    // Preconditions: None
+    // Postconditions: Returns the edges packed as u << 32 | v with u < v
+    const vector<uint64_t> &getEdges() const;
+
+
+    //----------------------------------- write --------------------------------
+    // Writes the edges as an edge list
+    // Preconditions: None
+    // Postconditions: One "u\tv" line per edge is written to out
+    void write(ostream &out) const;
+
+
+private:
+    SyntheticOptions options;               // model parameters
+    Random random;                          // seeded by options.seed
+    vector<uint64_t> edges;                 // sorted packed edges
+
+
+    //------------------------------ PRIVATE: add ------------------------------
+    // Adds the edge {u, v} unless it is a loop
+    // Preconditions: 0 <= u, v < options.vertices
+    // Postconditions: The packed edge is appended; duplicates are removed by
+    //                 deduplicate()
+    void add(const uint64_t &u, const uint64_t &v);
+
+
+    //-------------------------- PRIVATE: deduplicate --------------------------
+    // Sorts the edges and drops repeated ones
+    // Preconditions: None
+    // Postconditions: edges is sorted and holds every edge once
+    void deduplicate();
+
+
+    //--------------------------- PRIVATE: erdosRenyi --------------------------
+    // G(n, m) with m = n * degree / 2
+    // Preconditions: m does not exceed the number of vertex pairs
+    // Postconditions: edges holds m distinct uniformly chosen edges
+    void erdosRenyi();
+
+
+    //----------------------------- PRIVATE: chungLu ---------------------------
+    // Chung-Lu graph with power-law expected degrees
+    // Preconditions: options.exponent > 2
+    // Postconditions: n * degree / 2 endpoint pairs were drawn proportionally
+    //                 to the vertex weights; repeated pairs are kept once
+    void chungLu();
+
+
+    //---------------------------- PRIVATE: barabasi ---------------------------
+    // Barabasi-Albert preferential attachment
+    // Preconditions: None
+    // Postconditions: Every vertex after the first degree / 2 + 1 ones is
+    //                 linked to degree / 2 distinct earlier vertices chosen
+    //                 proportionally to their degree
+    void barabasi();
+
+
+    //-------------------------- PRIVATE: duplication --------------------------
+    // Duplication-divergence growth from a single edge
+    // Preconditions: None
+    // Postconditions: Vertices were added until there are options.vertices;
+    //                 a copy that ended up without edges was drawn again, up
+    //                 to DUPLICATION_DRAWS times, and then linked to the
+    //                 vertex it copied
+    void duplication();
+
+};
+
+#endif /* defined(__NemoSQL__SyntheticGraph__) */
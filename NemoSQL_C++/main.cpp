@@ -5,16 +5,128 @@
 //------------------------------------------------------------------------------
 // This is a driver for Motif Decection program
 //
+// Usage:
+//   main [input] [k] [--threads n] [--motif-adjacency motif output]
+//        [--take n] [--census [--checkpoint file [--checkpoint-interval s]
+//        [--resume]] [--progress s] [--stats] [--all-sizes]] [--estimate]
+//        [--randomize q [--seed s]] [--ensemble n [--swaps q]
+//        [--confidence c [--threshold t]] [--chain r]] [--updates file]
+//        [--diff input2 [--instances output]] [--store database]
+//        [--around v1,v2,... [--instances output]]
+//        [--level-wise [--levels prefix [--spill directory [--memory mb]]]]
+//        [--columns output]
+//        [--benchmark output [--repetitions n] [--counters]]
+//   main --generate model n output [--degree d] [--exponent x] [--retain q]
+//        [--link p] [--seed s]
+//   main --lookup file vertex [--class motif]
+//
+//   --motif-adjacency  writes, for every edge, the number of instances of the
+//                      motif ("triangle", "clique4" or a graph6 string) that
+//                      contain it as a "from to weight" edge list
+//   --take             prints the first n size-k subgraphs (vertices and the
+//                      graph6 string of their adjacency) and stops
+//   --census           prints the number of size-k subgraphs of every class
+//                      as "graph6 count" lines
+//   --checkpoint       saves the census progress to file every s seconds (60
+//                      by default); --resume continues from that file
+//   --progress         prints roots done, subgraphs/s and ETA every s seconds
+//                      during the census; SIGUSR1 prints the partial census
+//   --stats            prints the engine statistics of the census (only
+//                      collected when built with -DNEMO_STATS)
+//   --all-sizes        prints the census of every size from 3 to k, counted
+//                      in a single enumeration for size k (see
+//                      MultiCensus.h)
+//   --estimate         predicts the number of size-k subgraphs and the
+//                      runtime from random probes of the search tree
+//   --ensemble         compares the size-k census with those of n random
+//                      graphs with the same degrees (q edge switches per
+//                      edge, 10 by default) and prints "graph6 real mean
+//                      deviation z p" per class; with --confidence it stops
+//                      once every class is certain, at level c, to be above,
+//                      below or within t (2 by default) deviations of the mean;
+//                      with --chain the random graphs are sampled every r
+//                      switches per edge along Markov chains and their census
+//                      is updated incrementally
+//   --updates          counts the size-k subgraphs, then applies the edge
+//                      updates in file ("+ u v" inserts, "- u v" deletes)
+//                      one at a time, keeping the census current, and prints
+//                      the final census as "graph6 count" lines; updates
+//                      naming a negative vertex, or a new one from 2^24 up,
+//                      are ignored
+//   --diff             counts the size-k subgraphs of input, derives the
+//                      census of input2 (a later version of the same network)
+//                      from the edges that differ, and prints "graph6 count
+//                      count2" per class; --instances writes every instance
+//                      that disappeared ("-") or appeared ("+") to output
+//   --around           prints the number of size-k subgraphs of every class
+//                      that contain at least one of the given vertices, as
+//                      "graph6 count" lines, enumerating only around them;
+//                      --instances writes every such subgraph to output
+//   --store            writes the edges and every size-k subgraph with its
+//                      class into the SQLite database (tables edges, size<k>
+//                      and classes, see SubgraphStore.h); if the load fails
+//                      the size<k> table is dropped, not left half written
+//   --level-wise       counts the size-k subgraphs breadth first, growing
+//                      size 2, 3, ..., k from each other (see LevelWise.h);
+//                      with --levels every level j is saved as prefix.j, and
+//                      a run continues from the largest saved level <= k;
+//                      with --spill the levels stay on disk and are extended
+//                      file to file in mb megabytes (1024 by default),
+//                      spilling sorted runs to directory
+//   --columns          writes every size-k subgraph, sorted by class, to the
+//                      compressed columnar file output (see
+//                      InstanceColumns.h) and its vertex index to output.idx
+//                      (see InstanceIndex.h)
+//   --randomize        replaces the input by a random graph with the same
+//                      degrees (q edge switches per edge, see Randomizer.h)
+//                      before running any of the above
+//   --benchmark        times every engine variant for k = 3..6 (up to k when
+//                      given) and 1, 2, 4, ... threads (up to --threads) on
+//                      the input, or on every file in input/ when none is
+//                      given, and writes the results to output as JSON;
+//                      --repetitions keeps the best of n runs per case;
+//                      --counters adds the hardware counters of every case
+//                      where the system allows reading them
+//   --generate         writes a random n-vertex graph of the given model
+//                      ("erdos-renyi", "chung-lu", "barabasi" or
+//                      "duplication") to output as an edge list; the options
+//                      after it set its parameters (see SyntheticGraph.h);
+//                      --exponent must be greater than 2
+//   --lookup           prints the instances in the columnar file that contain
+//                      vertex, only those of the motif ("triangle",
+//                      "clique4" or a graph6 string) with --class; the
+//                      vertex index file.idx is used when it is present
+//
 // Assumptions:
-//   -- the "input.txt" text file must exist in the same directory as this
-//      programand, and it must be formatted as described in the specifications
+//   -- the input text file (input/Ecoli20111027CR_idx.txt unless given) must
+//      exist, and it must be formatted as described in the specifications
 //      stated in Graph.h
 //------------------------------------------------------------------------------
 
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include "Benchmark.h"
+#include "Census.h"
+#include "DifferentialCensus.h"
+#include "Ensemble.h"
+#include "Estimator.h"
 #include "Graph.h"
+#include "IncrementalCensus.h"
+#include "InstanceColumns.h"
+#include "InstanceIndex.h"
+#include "LevelWise.h"
+#include "LocalCensus.h"
+#include "MotifAdjacency.h"
+#include "MultiCensus.h"
+#include "Parallel.h"
+#include "Randomizer.h"
+#include "SyntheticGraph.h"
+#include "SubgraphGenerator.h"
+#include "SubgraphStore.h"
 
 using namespace std;
 
@@ -24,8 +136,238 @@ using namespace std;
 //                  in the specifications stated in Graph.h
 // Postconditions:  - The graph of the input will be generated
 //                  - The k-size subgraphs with be generated as called
-int main() {
-    ifstream infile1("/Users/shokorakis/Desktop/Homework_3/Homework_3/input/Ecoli20111027CR_idx.txt");
+int main(int argc, char *argv[]) {
+    const char *input = "input/Ecoli20111027CR_idx.txt";
+    int k = 5;
+    int threads = defaultThreads();
+    const char *motifName = nullptr;
+    const char *output = nullptr;
+    long long take = -1;
+    bool census = false;
+    bool estimate = false;
+    bool stats = false;
+    bool allSizes = false;
+    const char *benchmark = nullptr;
+    int repetitions = 1;
+    bool counters = false;
+    const char *model = nullptr;
+    SyntheticOptions synthetic;
+    double swapsPerEdge = -1;
+    EnsembleOptions ensemble;
+    bool significance = false;
+    const char *updates = nullptr;
+    const char *later = nullptr;
+    const char *instancesName = nullptr;
+    const char *database = nullptr;
+    vector<int> seeds;
+    bool levelWise = false;
+    string levelPrefix;
+    const char *spillDirectory = nullptr;
+    SpillOptions spill;
+    const char *columns = nullptr;
+    const char *lookup = nullptr;
+    uint32_t lookupVertex = 0;
+    const char *className = nullptr;
+    CensusOptions options;
+    
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--motif-adjacency") == 0 && i + 2 < argc) {
+            motifName = argv[++i];
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "--take") == 0 && i + 1 < argc)
+            take = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--census") == 0)
+            census = true;
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+            options.checkpoint = argv[++i];
+        else if (strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc)
+            options.checkpointSeconds = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--resume") == 0)
+            options.resume = true;
+        else if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc)
+            options.progressSeconds = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--estimate") == 0)
+            estimate = true;
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats = true;
+        else if (strcmp(argv[i], "--all-sizes") == 0)
+            allSizes = true;
+        else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+            benchmark = argv[++i];
+        else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+            repetitions = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--counters") == 0)
+            counters = true;
+        else if (strcmp(argv[i], "--generate") == 0 && i + 3 < argc) {
+            model = argv[++i];
+            synthetic.vertices = max(2, atoi(argv[++i]));
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc)
+            synthetic.degree = atof(argv[++i]);
+        else if (strcmp(argv[i], "--exponent") == 0 && i + 1 < argc)
+            synthetic.exponent = atof(argv[++i]);
+        else if (strcmp(argv[i], "--retain") == 0 && i + 1 < argc)
+            synthetic.retain = atof(argv[++i]);
+        else if (strcmp(argv[i], "--link") == 0 && i + 1 < argc)
+            synthetic.link = atof(argv[++i]);
+        else if (strcmp(argv[i], "--randomize") == 0 && i + 1 < argc)
+            swapsPerEdge = max(0.0, atof(argv[++i]));
+        else if (strcmp(argv[i], "--ensemble") == 0 && i + 1 < argc) {
+            significance = true;
+            ensemble.networks = max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--confidence") == 0 && i + 1 < argc)
+            ensemble.confidence = atof(argv[++i]);
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+            ensemble.threshold = max(0.0, atof(argv[++i]));
+        else if (strcmp(argv[i], "--chain") == 0 && i + 1 < argc)
+            ensemble.chainSwapsPerEdge = max(0.0, atof(argv[++i]));
+        else if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc)
+            updates = argv[++i];
+        else if (strcmp(argv[i], "--diff") == 0 && i + 1 < argc)
+            later = argv[++i];
+        else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+            instancesName = argv[++i];
+        else if (strcmp(argv[i], "--around") == 0 && i + 1 < argc) {
+            stringstream list(argv[++i]);
+            string vertex;
+            while (getline(list, vertex, ','))
+                seeds.push_back(atoi(vertex.c_str()));
+        }
+        else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc)
+            database = argv[++i];
+        else if (strcmp(argv[i], "--level-wise") == 0)
+            levelWise = true;
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc)
+            levelPrefix = argv[++i];
+        else if (strcmp(argv[i], "--spill") == 0 && i + 1 < argc)
+            spillDirectory = argv[++i];
+        else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc)
+            spill.memoryBytes = (size_t)max(1, atoi(argv[++i])) << 20;
+        else if (strcmp(argv[i], "--columns") == 0 && i + 1 < argc)
+            columns = argv[++i];
+        else if (strcmp(argv[i], "--lookup") == 0 && i + 2 < argc) {
+            lookup = argv[++i];
+            lookupVertex = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--class") == 0 && i + 1 < argc)
+            className = argv[++i];
+        else if (strcmp(argv[i], "--swaps") == 0 && i + 1 < argc)
+            ensemble.swapsPerEdge = max(0.0, atof(argv[++i]));
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            synthetic.seed = strtoull(argv[++i], nullptr, 10);
+        else if (argv[i][0] != '-' && positional == 0) {
+            input = argv[i];
+            positional++;
+        }
+        else if (argv[i][0] != '-' && positional == 1) {
+            k = atoi(argv[i]);
+            positional++;
+        }
+        else {
+            cerr << "Unknown argument " << argv[i] << endl;
+            return 1;
+        }
+    }
+    
+    if (k < 2 || k > MAX_SUBGRAPH_SIZE) {
+        cerr << "Subgraph size must be between 2 and " << MAX_SUBGRAPH_SIZE
+             << endl;
+        return 1;
+    }
+    if (!(synthetic.exponent > 2)) {
+        cerr << "Power-law exponent must be greater than 2" << endl;
+        return 1;
+    }
+    
+    if (model != nullptr) {
+        SyntheticGraph generator(synthetic);
+        if (!generator.generate(model)) {
+            cerr << "Unknown model " << model << endl;
+            return 1;
+        }
+        
+        ofstream outfile(output);
+        if (!outfile) {
+            cerr << "File could not be opened." << endl;
+            return 1;
+        }
+        generator.write(outfile);
+        cerr << generator.getEdges().size() << endl;
+        return 0;
+    }
+    
+    if (benchmark != nullptr) {
+        BenchmarkOptions suite;
+        suite.inputs = positional > 0 ? vector<string>(1, input)
+                                      : Benchmark::listInputs("input");
+        if (positional > 1)
+            suite.maxK = k;
+        suite.threads = threads;
+        suite.repetitions = repetitions;
+        suite.counters = counters;
+        
+        Benchmark runs(suite);
+        runs.run(cerr);
+        
+        ofstream outfile(benchmark);
+        if (!outfile) {
+            cerr << "File could not be opened." << endl;
+            return 1;
+        }
+        runs.writeJson(outfile);
+        return 0;
+    }
+    
+    if (lookup != nullptr) {
+        InstanceColumns table;
+        if (!table.open(lookup)) {
+            cerr << "Invalid instance file " << lookup << endl;
+            return 1;
+        }
+        
+        uint64_t type = 0;
+        int size = table.getSize();
+        if (className != nullptr &&
+            (!Classifier::parseMotif(className, type, size) ||
+             size != table.getSize())) {
+            cerr << "Unknown motif " << className << endl;
+            return 1;
+        }
+        
+        InstanceIndex index;
+        bool indexed = index.open(string(lookup) + ".idx") &&
+                       index.getRows() == table.getRows();
+        
+        vector<uint64_t> numbers;
+        vector<uint32_t> found;
+        auto start = chrono::high_resolution_clock::now();
+        long long decoded;
+        if (indexed)
+            decoded = index.find(type, lookupVertex, numbers);
+        else
+            decoded = table.find(type, lookupVertex, found);
+        auto end = chrono::high_resolution_clock::now();
+        if (indexed)
+            table.readRows(numbers, found);
+        
+        for (size_t i = 0; i < found.size(); i += size) {
+            for (int j = 0; j < size; j++)
+                cout << found[i + j] << (j + 1 < size ? "\t" : "\n");
+        }
+        cerr << found.size() / size << " instances, " << decoded
+             << (indexed ? " posting blocks" : " chunks") << " decoded in "
+             << chrono::duration_cast<chrono::microseconds>(end - start).count()
+             << " us" << endl;
+        return 0;
+    }
+    
+    ifstream infile1(input);
     if (!infile1) {
         cerr << "File could not be opened." << endl;
         return 1;
@@ -35,11 +377,231 @@ int main() {
     G.buildGraph(infile1);
     //infile1.close();
     
+    if (swapsPerEdge >= 0) {
+        Randomizer randomizer(G, synthetic.seed);
+        cerr << randomizer.randomize(swapsPerEdge) << " switches" << endl;
+        randomizer.buildGraph(G);
+    }
+    
     //G.displayAll();
     auto start = chrono::high_resolution_clock::now();
-    //G.enumerateSubgraph(3);
-    //G.enumerateSubgraph(4);
-    G.enumerateSubgraph(5);
+    
+    if (motifName != nullptr) {
+        uint64_t motif;
+        if (!Classifier::parseMotif(motifName, motif, k)) {
+            cerr << "Unknown motif " << motifName << endl;
+            return 1;
+        }
+        
+        MotifAdjacency adjacency(G, k, motif);
+        adjacency.compute(threads);
+        
+        ofstream outfile(output);
+        if (!outfile) {
+            cerr << "File could not be opened." << endl;
+            return 1;
+        }
+        adjacency.write(outfile);
+        cerr << adjacency.getEdges().size() << endl;
+    }
+    else if (significance) {
+        ensemble.threads = threads;
+        ensemble.seed = synthetic.seed;
+        
+        Ensemble test(G, k);
+        test.run(ensemble);
+        test.write(cout);
+        cerr << test.getNetworks() << " random networks"
+             << (test.isSettled() ? " (settled early)" : "") << endl;
+    }
+    else if (updates != nullptr) {
+        ifstream changes(updates);
+        if (!changes) {
+            cerr << "File could not be opened." << endl;
+            return 1;
+        }
+        
+        IncrementalCensus counts(G, k);
+        counts.run(threads);
+        
+        char op;
+        int u, v;
+        long long applied = 0, ignored = 0;
+        while (changes >> op >> u >> v) {
+            bool done = op == '+' ? counts.insertEdge(u, v)
+                      : op == '-' && counts.deleteEdge(u, v);
+            done ? applied++ : ignored++;
+        }
+        
+        counts.write(cout);
+        cerr << counts.getTotal() << " (" << applied << " updates, "
+             << ignored << " ignored)" << endl;
+    }
+    else if (later != nullptr) {
+        ifstream infile2(later);
+        if (!infile2) {
+            cerr << "File could not be opened." << endl;
+            return 1;
+        }
+        
+        Graph G2;
+        G2.buildGraph(infile2);
+        
+        ofstream instances;
+        if (instancesName != nullptr) {
+            instances.open(instancesName);
+            if (!instances) {
+                cerr << "File could not be opened." << endl;
+                return 1;
+            }
+        }
+        
+        DifferentialCensus diff(G, G2, k);
+        diff.run(threads, instancesName != nullptr ? &instances : nullptr);
+        diff.write(cout);
+        cerr << diff.getRemoved().size() << " edges removed, "
+             << diff.getAdded().size() << " added; "
+             << diff.getDisappeared() << " instances disappeared, "
+             << diff.getAppeared() << " appeared" << endl;
+    }
+    else if (!seeds.empty()) {
+        ofstream instances;
+        if (instancesName != nullptr) {
+            instances.open(instancesName);
+            if (!instances) {
+                cerr << "File could not be opened." << endl;
+                return 1;
+            }
+        }
+        
+        LocalCensus local(G, k);
+        local.run(seeds, instancesName != nullptr ? &instances : nullptr);
+        local.write(cout);
+        cerr << local.getTotal() << endl;
+    }
+    else if (database != nullptr) {
+        SubgraphStore store;
+        long long rows = -1;
+        if (store.open(database) && store.storeEdges(G))
+            rows = store.storeSubgraphs(G, k);
+        
+        if (rows < 0) {
+            cerr << "SQLite error: " << store.getError() << endl;
+            return 1;
+        }
+        cerr << rows << endl;
+    }
+    else if (columns != nullptr) {
+        long long rows = InstanceColumns::write(G, k, columns);
+        InstanceColumns table;
+        long long postings = -1;
+        if (rows >= 0 && table.open(columns))
+            postings = InstanceIndex::build(table, string(columns) + ".idx");
+        
+        if (postings < 0) {
+            cerr << "File could not be written." << endl;
+            return 1;
+        }
+        cerr << rows << " rows, " << postings << " postings" << endl;
+    }
+    else if (levelWise && spillDirectory != nullptr && !levelPrefix.empty()) {
+        LevelWise levels(G);
+        spill.directory = spillDirectory;
+        
+        int size = 0;
+        long long rows = 0;
+        for (int j = k; j >= 2 && size == 0; j--)
+            levels.probe(levelPrefix + "." + to_string(j), size, rows);
+        if (size == 0) {
+            levels.start();
+            size = 2;
+            rows = levels.getCount();
+            if (!levels.save(levelPrefix + ".2")) {
+                cerr << "Level could not be saved." << endl;
+                return 1;
+            }
+        }
+        cerr << "level " << size << ": " << rows << endl;
+        
+        for (; size < k; size++) {
+            rows = levels.extendFile(levelPrefix + "." + to_string(size),
+                                     levelPrefix + "." + to_string(size + 1),
+                                     spill);
+            if (rows < 0) {
+                cerr << "Level could not be extended." << endl;
+                return 1;
+            }
+            cerr << "level " << size + 1 << ": " << rows << " of "
+                 << levels.getGenerated() << " generated, "
+                 << levels.getRuns() << " runs spilled" << endl;
+        }
+        
+        cout << rows << endl;
+    }
+    else if (levelWise) {
+        LevelWise levels(G);
+        
+        bool resumed = false;
+        for (int j = k; j >= 2 && !levelPrefix.empty() && !resumed; j--)
+            resumed = levels.load(levelPrefix + "." + to_string(j));
+        if (!resumed)
+            levels.start();
+        cerr << "level " << levels.getSize() << ": " << levels.getCount()
+             << (resumed ? " (loaded)" : "") << endl;
+        
+        while (levels.getSize() < k) {
+            levels.extend(threads);
+            cerr << "level " << levels.getSize() << ": " << levels.getCount()
+                 << " of " << levels.getGenerated() << " generated" << endl;
+            
+            if (!levelPrefix.empty() &&
+                !levels.save(levelPrefix + "." + to_string(levels.getSize())))
+                cerr << "Level could not be saved." << endl;
+        }
+        
+        cout << levels.getCount() << endl;
+    }
+    else if (estimate) {
+        Estimator estimator(G, k);
+        Estimator::write(cout, estimator.estimate());
+    }
+    else if (census && allSizes) {
+        MultiCensus counts(G, min(3, k), k);
+        counts.run(threads);
+        counts.write(cout);
+        for (int size = min(3, k); size <= k; size++)
+            cerr << "k = " << size << ": " << counts.getTotal(size) << endl;
+    }
+    else if (census) {
+        options.threads = threads;
+        
+        if (options.progressSeconds > 0) {
+            Estimator estimator(G, k);
+            options.expectedLeaves = estimator.estimate().leaves;
+        }
+        
+        Census counts(G, k);
+        counts.run(options);
+        counts.write(cout);
+        cerr << counts.getTotal() << endl;
+        
+        if (stats)
+            counts.getStats().write(cerr, k);
+    }
+    else if (take >= 0) {
+        SubgraphGenerator instances(G, k);
+        
+        for (long long i = 0; i < take && instances.next(); i++) {
+            for (int j = 0; j < k; j++)
+                cout << instances.getSubgraph()[j] << "\t";
+            cout << Classifier::toGraph6(instances.getMask(), k) << "\n";
+        }
+    }
+    else {
+        //G.enumerateSubgraph(3);
+        //G.enumerateSubgraph(4);
+        G.enumerateSubgraph(k);
+    }
     
     auto end = chrono::high_resolution_clock::now();
     auto timeInSec = end - start;
@@ -48,4 +610,4 @@ int main() {
     cout << endl;
     
     return 0;
-}
\ No newline at end of file
+}